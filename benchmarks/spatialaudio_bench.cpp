@@ -0,0 +1,307 @@
+/*
+    Throughput of the processing classes, run with the spatialaudio-bench
+    target (cmake -DBUILD_BENCHMARKS=ON). Each benchmark reports the samples
+    processed per second and the real-time factor at 48 kHz (seconds of audio
+    processed per second of CPU time). The results are written as JSON to
+    spatialaudio-bench.json unless --benchmark_out is given. Use
+    --benchmark_filter to run a subset.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Ambisonics.h"
+#include "SpeakersBinauralizer.h"
+
+namespace {
+    const unsigned knSampleRate = 48000;
+    const unsigned knMinBlockSize = 32;
+    const unsigned knMaxBlockSize = 4096;
+
+    void OrdersAndBlocks(benchmark::internal::Benchmark* pBenchmark)
+    {
+        pBenchmark->ArgNames({"order", "block"});
+        for(int nOrder = 1; nOrder <= 3; nOrder++)
+            for(int nBlockSize = knMinBlockSize; nBlockSize <= (int)knMaxBlockSize; nBlockSize *= 2)
+                pBenchmark->Args({nOrder, nBlockSize});
+    }
+
+    /** Adds a third argument taking the values 0 to nValues - 1 */
+    template<int nValues>
+    void OrdersBlocksAnd(benchmark::internal::Benchmark* pBenchmark, const char* pcName)
+    {
+        pBenchmark->ArgNames({"order", "block", pcName});
+        for(int nOrder = 1; nOrder <= 3; nOrder++)
+            for(int nBlockSize = knMinBlockSize; nBlockSize <= (int)knMaxBlockSize; nBlockSize *= 2)
+                for(int nValue = 0; nValue < nValues; nValue++)
+                    pBenchmark->Args({nOrder, nBlockSize, nValue});
+    }
+
+    void SetThroughput(benchmark::State& state, unsigned nBlockSize)
+    {
+        state.SetItemsProcessed(state.iterations() * nBlockSize);
+        state.counters["realtime_factor"] = benchmark::Counter(
+            (double)state.iterations() * nBlockSize / knSampleRate, benchmark::Counter::kIsRate);
+    }
+
+    std::vector<float> Noise(unsigned nSamples)
+    {
+        std::vector<float> pfNoise(nSamples);
+        unsigned nSeed = 12345;
+        for(unsigned ni = 0; ni < nSamples; ni++)
+        {
+            nSeed = nSeed * 1664525u + 1013904223u;
+            pfNoise[ni] = (nSeed >> 8) / 16777216.f - 0.5f;
+        }
+        return pfNoise;
+    }
+
+    void FillBFormat(CBFormat& bFormat, unsigned nBlockSize)
+    {
+        std::vector<float> pfNoise = Noise(nBlockSize);
+        for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+            bFormat.InsertStream(pfNoise.data(), niChannel, nBlockSize);
+    }
+
+    const PolarPoint kSourcePosition = {DegreesToRadians(30.f), DegreesToRadians(10.f), 2.f};
+}
+
+static void BM_Encoder(benchmark::State& state)
+{
+    unsigned nOrder = (unsigned)state.range(0);
+    unsigned nBlockSize = (unsigned)state.range(1);
+    CAmbisonicEncoder encoder;
+    encoder.Configure(nOrder, true, 0);
+    encoder.SetPosition(kSourcePosition);
+    encoder.Refresh();
+    CBFormat bFormat;
+    bFormat.Configure(nOrder, true, nBlockSize);
+    std::vector<float> pfSrc = Noise(nBlockSize);
+
+    for(auto _ : state)
+    {
+        encoder.Process(pfSrc.data(), nBlockSize, &bFormat);
+        benchmark::ClobberMemory();
+    }
+    SetThroughput(state, nBlockSize);
+}
+BENCHMARK(BM_Encoder)->Apply(OrdersAndBlocks);
+
+static void BM_EncoderDist(benchmark::State& state)
+{
+    unsigned nOrder = (unsigned)state.range(0);
+    unsigned nBlockSize = (unsigned)state.range(1);
+    CAmbisonicEncoderDist encoder;
+    encoder.Configure(nOrder, true, knSampleRate);
+    encoder.SetPosition(kSourcePosition);
+    encoder.Refresh();
+    CBFormat bFormat;
+    bFormat.Configure(nOrder, true, nBlockSize);
+    std::vector<float> pfSrc = Noise(nBlockSize);
+
+    for(auto _ : state)
+    {
+        encoder.Process(pfSrc.data(), nBlockSize, &bFormat);
+        benchmark::ClobberMemory();
+    }
+    SetThroughput(state, nBlockSize);
+}
+BENCHMARK(BM_EncoderDist)->Apply(OrdersAndBlocks);
+
+static void BM_Decoder(benchmark::State& state)
+{
+    unsigned nOrder = (unsigned)state.range(0);
+    unsigned nBlockSize = (unsigned)state.range(1);
+    int nSpeakerSetUp = (int)state.range(2);
+    // The presets from kAmblib_Cube on are 3D arrays
+    bool b3D = nSpeakerSetUp >= kAmblib_Cube;
+    CAmbisonicDecoder decoder;
+    if(!decoder.Configure(nOrder, b3D, nSpeakerSetUp))
+    {
+        state.SkipWithError("speaker set-up not supported");
+        return;
+    }
+    CBFormat bFormat;
+    bFormat.Configure(nOrder, b3D, nBlockSize);
+    FillBFormat(bFormat, nBlockSize);
+    std::vector<std::vector<float>> ppfOut(decoder.GetSpeakerCount(), std::vector<float>(nBlockSize));
+    std::vector<float*> ppfDst;
+    for(auto& pfOut : ppfOut)
+        ppfDst.push_back(pfOut.data());
+
+    for(auto _ : state)
+    {
+        decoder.Process(&bFormat, nBlockSize, ppfDst.data());
+        benchmark::ClobberMemory();
+    }
+    SetThroughput(state, nBlockSize);
+}
+BENCHMARK(BM_Decoder)->Apply([](benchmark::internal::Benchmark* pBenchmark) {
+    OrdersBlocksAnd<kAmblib_NumOfSpeakerSetUps>(pBenchmark, "preset");
+});
+
+static void BM_Processor(benchmark::State& state)
+{
+    unsigned nOrder = (unsigned)state.range(0);
+    unsigned nBlockSize = (unsigned)state.range(1);
+    ProcessorShelfFilters eShelfFilter = (ProcessorShelfFilters)state.range(2);
+    CAmbisonicProcessor processor;
+    processor.Configure(nOrder, true, nBlockSize, 0);
+    processor.SetShelfFilter(eShelfFilter);
+    processor.SetOrientation(Orientation(0.3f, 0.2f, 0.1f));
+    processor.Refresh();
+    CBFormat bFormat;
+    bFormat.Configure(nOrder, true, nBlockSize);
+    FillBFormat(bFormat, nBlockSize);
+
+    for(auto _ : state)
+    {
+        processor.Process(&bFormat, nBlockSize);
+        benchmark::ClobberMemory();
+    }
+    SetThroughput(state, nBlockSize);
+}
+// shelf: 0 FIR shelf-filters, 1 IIR shelf-filters, 2 rotation only
+BENCHMARK(BM_Processor)->Apply([](benchmark::internal::Benchmark* pBenchmark) {
+    OrdersBlocksAnd<3>(pBenchmark, "shelf");
+});
+
+static void BM_Zoomer(benchmark::State& state)
+{
+    unsigned nOrder = (unsigned)state.range(0);
+    unsigned nBlockSize = (unsigned)state.range(1);
+    CAmbisonicZoomer zoomer;
+    zoomer.Configure(nOrder, true, 0);
+    zoomer.SetZoom(0.5f);
+    zoomer.Refresh();
+    CBFormat bFormat;
+    bFormat.Configure(nOrder, true, nBlockSize);
+    FillBFormat(bFormat, nBlockSize);
+
+    for(auto _ : state)
+    {
+        zoomer.Process(&bFormat, nBlockSize);
+        benchmark::ClobberMemory();
+    }
+    SetThroughput(state, nBlockSize);
+}
+BENCHMARK(BM_Zoomer)->Apply(OrdersAndBlocks);
+
+static void BM_Microphone(benchmark::State& state)
+{
+    unsigned nOrder = (unsigned)state.range(0);
+    unsigned nBlockSize = (unsigned)state.range(1);
+    CAmbisonicMicrophone microphone;
+    microphone.Configure(nOrder, true, 0);
+    microphone.SetPosition(kSourcePosition);
+    microphone.SetDirectivity(0.5f);
+    microphone.Refresh();
+    CBFormat bFormat;
+    bFormat.Configure(nOrder, true, nBlockSize);
+    FillBFormat(bFormat, nBlockSize);
+    std::vector<float> pfDst(nBlockSize);
+
+    for(auto _ : state)
+    {
+        microphone.Process(&bFormat, nBlockSize, pfDst.data());
+        benchmark::ClobberMemory();
+    }
+    SetThroughput(state, nBlockSize);
+}
+BENCHMARK(BM_Microphone)->Apply(OrdersAndBlocks);
+
+static void BM_Binauralizer(benchmark::State& state)
+{
+    unsigned nOrder = (unsigned)state.range(0);
+    unsigned nBlockSize = (unsigned)state.range(1);
+    CAmbisonicBinauralizer binauralizer;
+    unsigned nTailLength;
+    if(!binauralizer.Configure(nOrder, true, knSampleRate, nBlockSize, nTailLength))
+    {
+        state.SkipWithError("could not load the HRTF");
+        return;
+    }
+    binauralizer.SetLowCPU(state.range(2) != 0);
+    CBFormat bFormat;
+    bFormat.Configure(nOrder, true, nBlockSize);
+    FillBFormat(bFormat, nBlockSize);
+    std::vector<float> pfLeft(nBlockSize), pfRight(nBlockSize);
+    float* ppfDst[2] = {pfLeft.data(), pfRight.data()};
+
+    for(auto _ : state)
+    {
+        binauralizer.Process(&bFormat, ppfDst);
+        benchmark::ClobberMemory();
+    }
+    SetThroughput(state, nBlockSize);
+}
+// lowcpu: 1 for the symmetric head decoder
+BENCHMARK(BM_Binauralizer)->Apply([](benchmark::internal::Benchmark* pBenchmark) {
+    OrdersBlocksAnd<2>(pBenchmark, "lowcpu");
+});
+
+static void BM_SpeakersBinauralizer(benchmark::State& state)
+{
+    unsigned nSpeakers = (unsigned)state.range(0);
+    unsigned nBlockSize = (unsigned)state.range(1);
+    // L, R, C, LFE, Ls, Rs, Lb, Rb
+    const float pfAzimuth[] = {30.f, -30.f, 0.f, 0.f, 110.f, -110.f, 150.f, -150.f};
+    std::vector<CAmbisonicSpeaker> speakers(nSpeakers);
+    for(unsigned niSpeaker = 0; niSpeaker < nSpeakers; niSpeaker++)
+    {
+        PolarPoint position = {DegreesToRadians(pfAzimuth[niSpeaker]), 0.f, 1.f};
+        speakers[niSpeaker].Configure(1, true, 0);
+        speakers[niSpeaker].SetPosition(position);
+    }
+    SpeakersBinauralizer binauralizer;
+    unsigned nTailLength;
+    if(!binauralizer.Configure(knSampleRate, nBlockSize, speakers.data(), nSpeakers, nTailLength))
+    {
+        state.SkipWithError("could not load the HRTF");
+        return;
+    }
+    std::vector<float> pfNoise = Noise(nBlockSize);
+    std::vector<float*> ppfSrc(nSpeakers, pfNoise.data());
+    std::vector<float> pfLeft(nBlockSize), pfRight(nBlockSize);
+    float* ppfDst[2] = {pfLeft.data(), pfRight.data()};
+
+    for(auto _ : state)
+    {
+        binauralizer.Process(ppfSrc.data(), ppfDst);
+        benchmark::ClobberMemory();
+    }
+    SetThroughput(state, nBlockSize);
+}
+// stereo, 5.1 and 7.1
+BENCHMARK(BM_SpeakersBinauralizer)->Apply([](benchmark::internal::Benchmark* pBenchmark) {
+    pBenchmark->ArgNames({"speakers", "block"});
+    for(int nSpeakers : {2, 6, 8})
+        for(int nBlockSize = knMinBlockSize; nBlockSize <= (int)knMaxBlockSize; nBlockSize *= 2)
+            pBenchmark->Args({nSpeakers, nBlockSize});
+});
+
+int main(int argc, char** argv)
+{
+    // Write the JSON results to a file by default, the console keeps the readable table
+    std::vector<char*> ppcArgs(argv, argv + argc);
+    bool bOut = false;
+    for(int niArg = 1; niArg < argc; niArg++)
+        bOut = bOut || strncmp(argv[niArg], "--benchmark_out=", 16) == 0;
+    char pcOut[] = "--benchmark_out=spatialaudio-bench.json";
+    char pcOutFormat[] = "--benchmark_out_format=json";
+    if(!bOut)
+    {
+        ppcArgs.push_back(pcOut);
+        ppcArgs.push_back(pcOutFormat);
+    }
+    int nArgs = (int)ppcArgs.size();
+
+    benchmark::Initialize(&nArgs, ppcArgs.data());
+    if(benchmark::ReportUnrecognizedArguments(nArgs, ppcArgs.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,43 @@
+# Try to find the single precision FFTW3 headers and library.
+#
+# Usage of this module as follows:
+#
+#     find_package(FFTW3f)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+#  FFTW3F_ROOT_DIR           Set this variable to the root installation of
+#                            FFTW3 if the module has problems finding the
+#                            proper installation path.
+#
+# Variables defined by this module:
+#
+#  FFTW3F_FOUND               System has the fftw3f library/headers.
+#  FFTW3F_LIBRARIES           The fftw3f library.
+#  FFTW3F_INCLUDE_DIRS        The location of fftw3.h.
+
+find_path(FFTW3F_ROOT_DIR
+    NAMES include/fftw3.h
+)
+
+find_library(FFTW3F_LIBRARIES
+    NAMES fftw3f
+    HINTS ${FFTW3F_ROOT_DIR}/lib
+)
+
+find_path(FFTW3F_INCLUDE_DIRS
+    NAMES fftw3.h
+    HINTS ${FFTW3F_ROOT_DIR}/include
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(FFTW3f DEFAULT_MSG
+    FFTW3F_LIBRARIES
+    FFTW3F_INCLUDE_DIRS
+)
+
+mark_as_advanced(
+    FFTW3F_LIBRARIES
+    FFTW3F_INCLUDE_DIRS
+)
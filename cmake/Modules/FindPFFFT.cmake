@@ -0,0 +1,43 @@
+# Try to find PFFFT headers and library.
+#
+# Usage of this module as follows:
+#
+#     find_package(PFFFT)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+#  PFFFT_ROOT_DIR            Set this variable to the root installation of
+#                            PFFFT if the module has problems finding the
+#                            proper installation path.
+#
+# Variables defined by this module:
+#
+#  PFFFT_FOUND                System has the PFFFT library/headers.
+#  PFFFT_LIBRARIES            The PFFFT library.
+#  PFFFT_INCLUDE_DIRS         The location of pffft.h.
+
+find_path(PFFFT_ROOT_DIR
+    NAMES include/pffft.h
+)
+
+find_library(PFFFT_LIBRARIES
+    NAMES libpffft.a pffft
+    HINTS ${PFFFT_ROOT_DIR}/lib
+)
+
+find_path(PFFFT_INCLUDE_DIRS
+    NAMES pffft.h
+    HINTS ${PFFFT_ROOT_DIR}/include
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(PFFFT DEFAULT_MSG
+    PFFFT_LIBRARIES
+    PFFFT_INCLUDE_DIRS
+)
+
+mark_as_advanced(
+    PFFFT_LIBRARIES
+    PFFFT_INCLUDE_DIRS
+)
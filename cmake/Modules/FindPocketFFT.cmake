@@ -0,0 +1,32 @@
+# Try to find the header-only C++ pocketfft.
+#
+# Usage of this module as follows:
+#
+#     find_package(PocketFFT)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+#  POCKETFFT_ROOT_DIR        Set this variable to the directory containing
+#                            pocketfft_hdronly.h if the module has problems
+#                            finding it.
+#
+# Variables defined by this module:
+#
+#  POCKETFFT_FOUND            pocketfft_hdronly.h was found.
+#  POCKETFFT_INCLUDE_DIRS     The location of pocketfft_hdronly.h.
+
+find_path(POCKETFFT_INCLUDE_DIRS
+    NAMES pocketfft_hdronly.h
+    HINTS ${POCKETFFT_ROOT_DIR} ${POCKETFFT_ROOT_DIR}/include
+    PATH_SUFFIXES pocketfft
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(PocketFFT DEFAULT_MSG
+    POCKETFFT_INCLUDE_DIRS
+)
+
+mark_as_advanced(
+    POCKETFFT_INCLUDE_DIRS
+)
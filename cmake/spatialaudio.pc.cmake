@@ -5,5 +5,5 @@ includedir=${prefix}/include
 Name: libspatialaudio
 Description: Spatial audio rendering library
 Version: @PACKAGE_VERSION_MAJOR@.@PACKAGE_VERSION_MINOR@.@PACKAGE_VERSION_PATCH@
-Libs: -L${libdir} -lspatialaudio @MYSOFA_LIB@ -lm -lz
+Libs: -L${libdir} -lspatialaudio @MYSOFA_LIB@ @FFT_LIB@ @CMAKE_THREAD_LIBS_INIT@ -lm -lz
 Cflags: -I${includedir} @MYSOFA_INCLUDE@
@@ -21,7 +21,12 @@
 /// Ambisonic base class.
 
 /** This is the base class for most if not all of the classes that make up this
-    library. */
+    library.
+
+    Configure() is where memory is allocated, filters are computed and HRTFs
+    are read, so it must not be called from the audio thread. Once configured,
+    Process(), Refresh(), Reset() and the Set*() parameter methods never
+    allocate, lock or do any I/O and can be called from a real-time thread. */
 
 class CAmbisonicBase
 {
@@ -0,0 +1,88 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CAmbisonicBatchEncoder - Ambisonic Batch Encoder                        #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      AmbisonicBatchEncoder.h                                  #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef _AMBISONIC_BATCH_ENCODER_H
+#define _AMBISONIC_BATCH_ENCODER_H
+
+#include <vector>
+
+#include "AmbisonicBase.h"
+#include "BFormat.h"
+
+/// Ambisonic encoder for many sources.
+
+/** Encodes several mono sources into one B-Format stream in a single pass,
+    without intermediate CBFormat objects. Each source has its own position
+    and gain, as with CAmbisonicEncoder. */
+
+class CAmbisonicBatchEncoder : public CAmbisonicBase
+{
+public:
+    CAmbisonicBatchEncoder();
+    ~CAmbisonicBatchEncoder();
+    /**
+        Re-create the object for the given configuration. Previous data is
+        lost. The last argument is the number of sources. Returns true if
+        successful.
+    */
+    virtual bool Configure(unsigned nOrder, bool b3D, unsigned nSources);
+    /**
+        Not implemented.
+    */
+    void Reset();
+    /**
+        Recalculate the coefficients of the sources whose position or gain
+        changed since the last call.
+    */
+    void Refresh();
+    /**
+        Get the number of sources.
+    */
+    unsigned GetSourceCount();
+    /**
+        Set azimuth, elevation, and distance settings of a source.
+    */
+    void SetPosition(unsigned nSource, PolarPoint polPosition);
+    /**
+        Get azimuth, elevation, and distance settings of a source.
+    */
+    PolarPoint GetPosition(unsigned nSource);
+    /**
+        Sets the gain of a source.
+    */
+    void SetGain(unsigned nSource, float fGain);
+    /**
+        Gets the gain of a source.
+    */
+    float GetGain(unsigned nSource);
+    /**
+        Encode the mix of all the mono streams to B-Format. ppfSrc holds one
+        pointer per source. The destination is overwritten.
+    */
+    void Process(float** ppfSrc, unsigned nSamples, CBFormat* pBFDst);
+
+protected:
+    unsigned m_nSources;
+    std::vector<PolarPoint> m_polPositions;
+    std::vector<float> m_pfGains;
+    std::vector<bool> m_pbDirty;
+    std::vector<float> m_pfNormalisation;
+    /** Coefficient matrix, channels x sources */
+    std::vector<float> m_pfCoeff;
+    /** Coefficients of one source */
+    std::vector<float> m_pfSourceCoeff;
+};
+
+#endif // _AMBISONIC_BATCH_ENCODER_H
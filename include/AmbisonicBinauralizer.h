@@ -17,12 +17,18 @@
 #ifndef _AMBISONIC_BINAURALIZER_H
 #define _AMBISONIC_BINAURALIZER_H
 
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "AmbisonicDecoder.h"
 #include "AmbisonicEncoder.h"
-#include "kiss_fftr.h"
+#include "BFormatView.h"
+#include "fft.h"
+#include "spectrum.h"
+#include "BinauralFilterSet.h"
+#include "FilterCache.h"
 
 #include "mit_hrtf.h"
 #include "sofa_hrtf.h"
@@ -35,11 +41,16 @@ class CAmbisonicBinauralizer : public CAmbisonicBase
 {
 public:
     CAmbisonicBinauralizer();
+    virtual ~CAmbisonicBinauralizer();
     /**
         Re-create the object for the given configuration. Previous data is
         lost. The tailLength variable it updated with the number of taps
         used for the processing, and this can be used to offset the delay
         this causes. The function returns true if the call is successful.
+        If the HRTFs are longer than nBlockSize they are split into partitions
+        of nBlockSize taps and convolved with a uniformly partitioned
+        frequency-domain convolution, so the cost of each block stays
+        bounded for small blocks and long (e.g. SOFA) filters.
     */
     virtual bool Configure(unsigned nOrder,
                            bool b3D,
@@ -47,6 +58,50 @@ public:
                            unsigned nBlockSize,
                            unsigned& tailLength,
                            std::string HRTFPath = "");
+    /**
+        Build a new configuration on a background thread while Process() goes
+        on with the current one, e.g. to change the HRTF during playback.
+        Once it is built, Process() switches to it at the start of the first
+        block whose B-Format input has the new order, height and block size,
+        so a change of format needs the caller to change its input buffer
+        too. If bCrossfade is set and the input also suits the current
+        configuration, the first block is computed with both and faded from
+        the old filters to the new ones, otherwise the switch is immediate.
+        When the new configuration only changes the filters (same FFT size
+        and partitions), it goes on from the input already received, so the
+        tail of the partitioned convolution is not lost.
+        The switch never blocks nor allocates on the thread calling
+        Process(). A pending configuration that has not been switched to is
+        dropped by the next Configure() or ConfigureAsync(). The state that
+        was switched from stays allocated until CollectGarbage(), the next
+        Configure() or ConfigureAsync(), or the destructor frees it. Returns
+        false if the thread cannot be started. SpeakersBinauralizer does not
+        support it and always returns false.
+    */
+    virtual bool ConfigureAsync(unsigned nOrder,
+                        bool b3D,
+                        unsigned nSampleRate,
+                        unsigned nBlockSize,
+                        std::string HRTFPath = "",
+                        bool bCrossfade = false);
+    /**
+        Wait until the configuration requested by ConfigureAsync() is built.
+        Returns false if it could not be, otherwise tailLength is updated as
+        by Configure().
+    */
+    bool WaitForConfigure(unsigned& tailLength);
+    /**
+        Returns true from ConfigureAsync() until Process() has switched to
+        the new configuration or until building it has failed.
+    */
+    bool IsConfigurePending();
+    /**
+        Free the filters and buffers of the configurations Process() has
+        switched away from since ConfigureAsync(). Call it from a control
+        thread once IsConfigurePending() returns false, never from the audio
+        thread. It may be called while another thread runs Process().
+    */
+    void CollectGarbage();
     /**
         Resets members.
     */
@@ -58,11 +113,47 @@ public:
     /**
         Decode B-Format to binaural feeds. There is no arguement for the number
         of samples to process, as this is determined by the nBlockSize argument
-        in the constructor and Configure() function. It is the responsibility of
-        program using this library to handle the blocks of the signal by FIFO
-        buffers or other means.
+        in the constructor and Configure() function. Hosts whose blocks vary
+        in size can use the Process() below, which buffers the signal.
     */
     void Process(CBFormat* pBFSrc, float** ppfDst);
+    /**
+        Decode nSamples of B-Format to binaural feeds, for hosts whose
+        callbacks vary in size. Any nSamples is accepted: the samples go
+        through a FIFO one block (nBlockSize) long, which delays the output by
+        nBlockSize samples, whatever the sizes of the calls. pBFSrc must have
+        the configured order and height and hold at least nSamples samples.
+        A configuration built by ConfigureAsync() is switched to at a block
+        boundary of the FIFO if it has the same order, height and block size,
+        as for a change of HRTF; changing the format needs Configure(). Do not
+        mix with the Process() above on the same object.
+    */
+    void Process(CBFormat* pBFSrc, float** ppfDst, unsigned nSamples);
+    /**
+        Use a symmetric head model to halve the number of convolutions. Only
+        the left ear filters are convolved and the right ear is built by
+        adding or subtracting each convolved channel depending on its
+        left-right symmetry. The setting takes effect from the next call to
+        Process() and can be changed between blocks.
+    */
+    void SetLowCPU(bool bLowCPU);
+    /**
+        Returns true if the symmetric head model is used.
+    */
+    bool GetLowCPU();
+    /**
+        Keep the frequency domain filters in files in the directory
+        sDirectory, which must already exist. Configure() then loads the
+        filters of a configuration already seen (same HRTF, order, sample rate
+        and block size) without reading the HRTF, and stores new ones. A SOFA
+        file is recognised by its path, size and modification time. An empty
+        string (the default) disables the cache.
+    */
+    void SetFilterCacheDirectory(std::string sDirectory);
+    /**
+        Get the filter cache directory.
+    */
+    std::string GetFilterCacheDirectory();
 
 protected:
     CAmbisonicDecoder m_AmbDecoder;
@@ -73,20 +164,144 @@ protected:
     unsigned m_nFFTBins;
     float m_fFFTScaler;
     unsigned m_nOverlapLength;
+    unsigned m_nPartitions;
+    unsigned m_nFDLPosition;
+    bool m_bLowCPU;
+
+    CFilterCache m_FilterCache;
 
-    std::unique_ptr<struct kiss_fftr_state, decltype(&kiss_fftr_free)> m_pFFT_cfg;
-    std::unique_ptr<struct kiss_fftr_state, decltype(&kiss_fftr_free)> m_pIFFT_cfg;
-    std::vector<std::unique_ptr<kiss_fft_cpx[]>> m_ppcpFilters[2];
+    std::unique_ptr<FFT> m_pFFT;
+    /** Filters, shared with the other binauralizers using the same ones */
+    std::shared_ptr<const CBinauralFilterSet> m_pFilters;
     std::unique_ptr<kiss_fft_cpx[]> m_pcpScratch;
+    std::unique_ptr<kiss_fft_cpx[]> m_pcpAccumulator[2];
+    std::vector<std::unique_ptr<kiss_fft_cpx[]>> m_ppcpFDL;
+
+    //Sign of each channel for a source mirrored from left to right
+    std::vector<float> m_pfSymmetrySign;
 
     std::vector<float> m_pfScratchBufferA;
     std::vector<float> m_pfScratchBufferB;
-    std::vector<float> m_pfScratchBufferC;
     std::vector<float> m_pfOverlap[2];
+    std::vector<std::vector<float>> m_ppfInputHistory;
+
+    /** Background configuration. Each request gets a number and the
+        configuration built for it is published in m_pNextConfiguration.
+        Process() takes it and keeps it in m_pWaitingConfiguration until the
+        input is in its format, unless a newer request comes first. The
+        states it is done with are pushed on the m_pRetiredConfigurations
+        list, linked by m_pNextRetired, to be freed outside of the audio
+        thread. Pointers only change hands through atomic exchanges, so
+        nothing is ever freed while another thread uses it. */
+    std::thread m_ConfigureThread;
+    bool m_bConfigureSuccess;
+    unsigned m_nConfigureTailLength;
+    std::atomic<unsigned> m_nConfigureRequest;
+    std::atomic<unsigned> m_nConfigureDone;
+    unsigned m_nConfigureId;
+    std::atomic<CAmbisonicBinauralizer*> m_pNextConfiguration;
+    CAmbisonicBinauralizer* m_pWaitingConfiguration;
+    std::atomic<CAmbisonicBinauralizer*> m_pRetiredConfigurations;
+    CAmbisonicBinauralizer* m_pNextRetired;
+    /** Set on a configuration built to be faded in, with the output of the
+        configuration it replaces */
+    bool m_bCrossfade;
+    std::vector<float> m_pfCrossfade[2];
+
+    /** FIFOs of the Process() taking any number of samples, one block long,
+        and m_BFInputFifo viewing the input one as B-Format. They are not part
+        of the configuration exchanged by SwapConfiguration(). */
+    std::vector<std::vector<float>> m_ppfInputFifo;
+    std::vector<float*> m_ppfInputFifoChannels;
+    std::vector<float> m_pfOutputFifo[2];
+    unsigned m_nFifoPosition;
+    CBFormatView m_BFInputFifo;
 
     HRTF *getHRTF(unsigned nSampleRate, std::string HRTFPath);
+    /**
+        Identify the HRTF in the keys of the filter registry and cache.
+        Returns an empty string if it cannot be identified.
+    */
+    std::string GetHRTFKey(unsigned nSampleRate, std::string HRTFPath);
+    /**
+        Use the filters registered for sKey by another binauralizer, or else
+        the ones stored for it in the filter cache, and allocate the buffers
+        for them. Returns false if there are none, in which case the filters
+        have to be built.
+    */
+    bool FindFilters(const std::string& sKey, unsigned& tailLength);
+    /**
+        Use the filters just built and share them under sKey with the other
+        binauralizers and the filter cache.
+    */
+    void ShareFilters(const std::string& sKey, std::shared_ptr<CBinauralFilterSet> pFilters);
+    /**
+        Wait for the background configuration thread and free the
+        configurations it left behind. Not to be called from the audio
+        thread.
+    */
+    void DiscardConfigure();
+    /**
+        Hand a configuration Process() is done with to be freed. Lock-free.
+    */
+    void RetireConfiguration(CAmbisonicBinauralizer* pConfiguration);
+    /**
+        Free the retired configurations. Not to be called from the audio
+        thread. Used by CollectGarbage().
+    */
+    void FreeRetiredConfigurations();
+    /**
+        Returns true if pBFSrc has the order, height and block size of this
+        configuration.
+    */
+    bool IsFormatOf(CBFormat* pBFSrc);
+    /**
+        Exchange the processing state (filters, buffers and FFT) with other.
+        Only pointers are exchanged, nothing is allocated.
+    */
+    void SwapConfiguration(CAmbisonicBinauralizer& other);
+    /**
+        Copy the input delay lines, their position and the overlap of other,
+        which are the same whatever the filters, if both have the same
+        channel count, block size, FFT size and partitions. Returns false,
+        leaving this unchanged, if they do not. Nothing is allocated.
+    */
+    bool CopyInputState(const CAmbisonicBinauralizer& other);
     virtual void ArrangeSpeakers();
     virtual void AllocateBuffers();
+    /**
+        Calculate the FFT size, overlap length and number of partitions from
+        m_nTaps and m_nBlockSize.
+    */
+    void ConfigureFFTSize();
+    /**
+        Convert the time domain filter pfTaps (m_nTaps long) to the frequency
+        domain. When the filter is partitioned, pcpFilter receives the
+        spectra of all m_nPartitions partitions one after the other.
+    */
+    void ConvertFilter(const float* pfTaps, kiss_fft_cpx* pcpFilter);
+    /**
+        Convolve the m_nChannelCount input channels with the filters and sum
+        them to the two ear signals. All channels share one forward FFT each
+        and the sum is done in the frequency domain so only one inverse FFT
+        is needed per ear.
+    */
+    void ProcessConvolution(float** ppfSrc, float** ppfDst, bool bLowCPU);
+    /**
+        Uniformly partitioned overlap-save convolution used when the filters
+        are longer than the block size.
+    */
+    void ProcessPartitioned(float** ppfSrc, float** ppfDst, bool bLowCPU);
+    /**
+        Push nSamples of the m_nChannelCount channels of ppfSrc in the input
+        FIFO and pop nSamples of output, calling ProcessFifoBlock() every time
+        the input FIFO is full.
+    */
+    void ProcessBuffered(float* const* ppfSrc, float** ppfDst, unsigned nSamples);
+    /**
+        Process the full input FIFO to ppfDst.
+    */
+    virtual void ProcessFifoBlock(float** ppfDst);
 };
 
 #endif // _AMBISONIC_BINAURALIZER_H
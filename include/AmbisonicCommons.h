@@ -47,6 +47,12 @@ enum BFormatChannels3D
     kNumOfBformatChannels2D
 };*/
 
+/// Spherical harmonic normalisation schemes.
+enum AmbisonicNormalisation
+{
+    kSN3D, kN3D, kFuMa
+};
+
 /// Struct for source positioning in soundfield.
 typedef struct PolarPoint
 {
@@ -91,4 +97,29 @@ unsigned OrderToSpeakers(unsigned nOrder, bool b3D);
 */
 char ComponentToChannelLabel(unsigned nComponent, bool b3D);
 
+/**
+    Fill pfNorm with the normalisation factor of each component of a BFormat
+    stream of the given configuration, for use with SphericalHarmonics().
+    FuMa weights are only defined up to 3rd order, higher orders use SN3D.
+*/
+void SphericalHarmonicNormalisation(unsigned nOrder, bool b3D, AmbisonicNormalisation eNorm, float* pfNorm);
+
+/**
+    Evaluate the real spherical harmonics of all components up to nOrder in
+    the given direction (ACN order for 3D, W X Y U V ... for 2D), each
+    multiplied by its factor from SphericalHarmonicNormalisation(). Uses the
+    associated Legendre and Chebyshev recursions, so any order is supported
+    and only one sin/cos pair per angle is computed.
+*/
+void SphericalHarmonics(unsigned nOrder, bool b3D, float fAzimuth, float fElevation, const float* pfNorm, float* pfCoeff);
+
+/**
+    Multiply nInputs streams by an nOutputs x nInputs row major gain matrix:
+    ppfOut[o] = sum over i of pfMatrix[o * nInputs + i] * ppfIn[i], for
+    nSamples samples. The outputs are overwritten and must not alias the
+    inputs.
+*/
+void MatrixMix(const float* pfMatrix, unsigned nOutputs, unsigned nInputs,
+               const float* const* ppfIn, float* const* ppfOut, unsigned nSamples);
+
 #endif //_AMBISONICCOMMONS_H
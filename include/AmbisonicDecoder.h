@@ -20,6 +20,9 @@
 #include "AmbisonicBase.h"
 #include "BFormat.h"
 #include "AmbisonicSpeaker.h"
+#include "Biquad.h"
+
+#include <vector>
 
 enum Amblib_SpeakerSetUps
 {
@@ -109,13 +112,65 @@ public:
         specified speaker. Useful for presets for irregular physical loudspeakery arrays
     */
     void SetCoefficient(unsigned nSpeaker, unsigned nChannel, float fCoeff);
+    /**
+        Enable or disable dual-band decoding. The B-Format channels are split
+        with 4th order Linkwitz-Riley crossovers: the low band is decoded with
+        the basic decoder and the high band with the max-rE decoder (energy
+        normalised). If fCrossoverFrequency is 0, a frequency depending on the
+        order is used. The setting is kept when Configure() is called again.
+        The crossovers are allocated by Configure(), so this call does not
+        allocate and can be made between blocks.
+    */
+    void SetDualBand(bool bDualBand, unsigned nSampleRate = DEFAULT_SAMPLERATE, float fCrossoverFrequency = 0.f);
+    /**
+        Returns true if dual-band decoding is enabled.
+    */
+    bool GetDualBand();
+    /**
+        Returns the crossover frequency used for dual-band decoding.
+    */
+    float GetCrossoverFrequency();
 
 protected:
     void SpeakerSetUp(int nSpeakerSetUp, unsigned nSpeakers = 1);
+    /**
+        Rebuild the decoding matrix from the speaker coefficients.
+    */
+    void UpdateDecoderMatrix();
+    /**
+        Allocate the crossovers and compute the max-rE band gains for the
+        current configuration.
+    */
+    void ConfigureDualBand();
+    /**
+        Compute the crossover frequency and set the crossover coefficients,
+        without allocating.
+    */
+    void UpdateCrossover();
+    void ProcessDualBand(CBFormat* pBFSrc, unsigned nSamples, float** ppfDst);
 
     int m_nSpeakerSetUp;
     unsigned m_nSpeakers;
     CAmbisonicSpeaker* m_pAmbSpeakers;
+    /** Gains from each channel to each speaker, speakers x channels,
+        including the scaling for SN3D inputs */
+    std::vector<float> m_pfDecoderMatrix;
+    bool m_bDecoderMatrixDirty;
+
+    bool m_bDualBand;
+    unsigned m_nSampleRate;
+    float m_fCrossoverRequested;
+    float m_fCrossoverFrequency;
+    /** Two sections in series per channel for each band */
+    std::vector<CBiquad> m_LowPass;
+    std::vector<CBiquad> m_HighPass;
+    /** max-rE gain of the high band of each channel */
+    std::vector<float> m_pfHighGain;
+    /** Band-recombined input chunk, channels x knDualBandChunk */
+    std::vector<float> m_pfBandScratch;
+    std::vector<float> m_pfHighScratch;
+    std::vector<float*> m_ppfChunkIn;
+    std::vector<float*> m_ppfChunkOut;
 };
 
 #endif // _AMBISONIC_DECODER_H
@@ -43,6 +43,22 @@ public:
         Encode mono stream to B-Format.
     */
     void Process(float* pfSrc, unsigned nSamples, CBFormat* pBFDst);
+    /**
+        When enabled, Process() ramps each coefficient linearly from the
+        values used for the previous block to the current ones across the
+        block, avoiding zipper noise on moving sources. Disabled by default.
+    */
+    void SetInterpolation(bool bInterpolate);
+    /**
+        Returns true if the coefficients are interpolated across each block.
+    */
+    bool GetInterpolation();
+
+protected:
+    bool m_bInterpolate;
+    /** Coefficients used at the end of the previous block */
+    std::vector<float> m_pfCoeffPrevious;
+    bool m_bCoeffPreviousValid;
 };
 
 #endif // _AMBISONIC_ENCODER_H
@@ -48,7 +48,9 @@ public:
     */
     virtual void Refresh();
     /**
-        Encode mono stream to B-Format.
+        Encode mono stream to B-Format. With SetInterpolation(true) the gain
+        of each channel, including the distance gains, is ramped across the
+        block. The delay follows the distance at the start of the block.
     */
     void Process(float* pfSrc, unsigned nSamples, CBFormat* pBFDst);
     /**
@@ -74,6 +76,11 @@ protected:
     float m_fRoomRadius;
     float m_fInteriorGain;
     float m_fExteriorGain;
+    /** Gain step of each channel per sample while interpolating */
+    std::vector<float> m_pfGainStep;
+
+    /** Coefficient of channel nChannel times its interior or exterior gain */
+    float GetChannelGain(unsigned nChannel);
 };
 
 #endif // _AMBISONIC_ENCODER_DIST_H
@@ -45,9 +45,17 @@ public:
         Get the microphone's directivity.
     */
     float GetDirectivity();
+    /**
+        Set the directivity from a control thread, applied at the start of
+        the next Process() as with PostPosition().
+    */
+    void PostDirectivity(float fDirectivity);
 
 protected:
     float m_fDirectivity;
+    CParameterQueue<float> m_DirectivityQueue;
+
+    bool ApplyPostedParameters();
 };
 
 #endif // _AMBISONIC_MICROPHONE_H
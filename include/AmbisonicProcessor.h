@@ -19,9 +19,12 @@
 
 #include "AmbisonicBase.h"
 #include "BFormat.h"
-#include "kiss_fftr.h"
+#include "fft.h"
+#include "spectrum.h"
 #include "AmbisonicPsychoacousticFilters.h"
 #include "AmbisonicZoomer.h"
+#include "Biquad.h"
+#include "ParameterQueue.h"
 
 enum ProcessorDOR
 {
@@ -36,6 +39,13 @@ enum ProcessorModes
     kNumProcessorModes
 };
 
+enum ProcessorShelfFilters
+{
+    kShelfFIR, //linear phase, delays the signal by half the filter length
+    kShelfIIR, //minimum phase, no delay
+    kShelfNone //no psychoacoustic optimisation, rotation only
+};
+
 
 class CAmbisonicProcessor;
 
@@ -111,13 +121,16 @@ private:
 /// Ambisonic processor.
 
 /** This object is used to rotate the BFormat signal around all three axes.
-    Orientation structs are used to define the the soundfield's orientation. */
+    Orientation structs are used to define the the soundfield's orientation.
+    It owns its FFT and filter buffers and cannot be copied, configure a new
+    one instead. */
 
 class CAmbisonicProcessor : public CAmbisonicBase
 {
 public:
     CAmbisonicProcessor();
-    ~CAmbisonicProcessor();
+    CAmbisonicProcessor(const CAmbisonicProcessor&) = delete;
+    CAmbisonicProcessor& operator = (const CAmbisonicProcessor&) = delete;
     /**
         Re-create the object for the given configuration. Previous data is
         lost. The last argument is not used, it is just there to match with 
@@ -136,6 +149,38 @@ public:
         Set yaw, roll, and pitch settings.
     */
     void SetOrientation(Orientation orientation);
+    /**
+        Set the orientation from a control thread, e.g. a head-tracker, while
+        another thread calls Process(). The orientation is applied, with a
+        Refresh(), at the start of the next Process(). If several are posted
+        in between, only the last one is applied. Only one thread may post.
+    */
+    void PostOrientation(Orientation orientation);
+    /**
+        Set the number of samples over which the rotation moves from the
+        previous orientation to the new one after each Refresh(), to avoid
+        zipper noise with frequent head-tracker updates. Use the block size to
+        ramp over one block. 0 (the default) applies new orientations
+        immediately. Any ramp in progress is finished.
+    */
+    void SetRampLength(unsigned nSamples);
+    /**
+        Get the orientation ramp length in samples.
+    */
+    unsigned GetRampLength();
+    /**
+        Select the implementation of the psychoacoustic optimisation
+        shelf-filters. kShelfFIR (the default) uses the linear phase FIR
+        filters, which delay the signal by 50 samples. kShelfIIR uses minimum
+        phase biquads with approximately the same magnitude response, which
+        have no delay and are cheaper. kShelfNone turns the optimisation off.
+        The filter state is cleared.
+    */
+    void SetShelfFilter(ProcessorShelfFilters eShelfFilter);
+    /**
+        Get the implementation of the psychoacoustic optimisation shelf-filters.
+    */
+    ProcessorShelfFilters GetShelfFilter();
     /**
         Get yaw, roll, and pitch settings.
     */
@@ -146,24 +191,31 @@ public:
     void Process(CBFormat* pBFSrcDst, unsigned nSamples);
 
 private:
-    void ProcessOrder1_3D(CBFormat* pBFSrcDst, unsigned nSamples);
-    void ProcessOrder2_3D(CBFormat* pBFSrcDst, unsigned nSamples);
-    void ProcessOrder3_3D(CBFormat* pBFSrcDst, unsigned nSamples);
-    void ProcessOrder1_2D(CBFormat* pBFSrcDst, unsigned nSamples);
-    void ProcessOrder2_2D(CBFormat* pBFSrcDst, unsigned nSamples);
-    void ProcessOrder3_2D(CBFormat* pBFSrcDst, unsigned nSamples);
+    /** Number of samples rotated at a time by ProcessOrder() */
+    static const unsigned knRotationChunk = 64;
+
+    /**
+        Rotate the channels of one order with its composed rotation matrix.
+    */
+    void ProcessOrder(float** ppfChannels, unsigned nOrder, unsigned nSamples);
+    /**
+        Rotation matrix of order nOrder (> 1) from the first order matrix and
+        the matrix of order nOrder - 1.
+    */
+    static void RecurseRotationMatrix(unsigned nOrder, const float* pfR1, const float* pfPrev, float* pfMatrix);
 
     void ShelfFilterOrder(CBFormat* pBFSrcDst, unsigned nSamples);
+    void ShelfFilterOrderIIR(CBFormat* pBFSrcDst, unsigned nSamples);
 
 protected:
     Orientation m_orientation;
-    float* m_pfTempSample;
+    CParameterQueue<Orientation> m_OrientationQueue;
+    std::vector<float> m_pfTempSample;
 
-    kiss_fftr_cfg m_pFFT_psych_cfg;
-    kiss_fftr_cfg m_pIFFT_psych_cfg;
+    std::unique_ptr<FFT> m_pFFT_psych;
 
-    float* m_pfScratchBufferA;
-    float** m_pfOverlap;
+    std::vector<float> m_pfScratchBufferA;
+    std::vector<std::vector<float>> m_pfOverlap;
     unsigned m_nFFTSize;
     unsigned m_nBlockSize;
     unsigned m_nTaps;
@@ -171,27 +223,25 @@ protected:
     unsigned m_nFFTBins;
     float m_fFFTScaler;
 
-    kiss_fft_cpx** m_ppcpPsychFilters;
-    kiss_fft_cpx* m_pcpScratch;
-
-    float m_fCosAlpha;
-    float m_fSinAlpha;
-    float m_fCosBeta;
-    float m_fSinBeta;
-    float m_fCosGamma;
-    float m_fSinGamma;
-    float m_fCos2Alpha;
-    float m_fSin2Alpha;
-    float m_fCos2Beta;
-    float m_fSin2Beta;
-    float m_fCos2Gamma;
-    float m_fSin2Gamma;
-    float m_fCos3Alpha;
-    float m_fSin3Alpha;
-    float m_fCos3Beta;
-    float m_fSin3Beta;
-    float m_fCos3Gamma;
-    float m_fSin3Gamma;
+    std::vector<std::unique_ptr<kiss_fft_cpx[]>> m_ppcpPsychFilters;
+    std::unique_ptr<kiss_fft_cpx[]> m_pcpScratch;
+
+    ProcessorShelfFilters m_eShelfFilter;
+    /** Biquad sections of the minimum phase shelf-filters, knMaxShelfSections per channel */
+    static const unsigned knMaxShelfSections = 2;
+    std::vector<CBiquad> m_ShelfIIR;
+    /** Number of sections used by the shelf-filter of each order */
+    std::vector<unsigned> m_pnShelfSections;
+    /** Low frequency gain of the shelf-filter of each order */
+    std::vector<float> m_pfShelfGain;
+
+    /** Composed rotation matrix of each order, (2n+1)x(2n+1) row major */
+    std::vector<std::vector<float>> m_ppfRotation;
+    /** Rotation matrices the current ramp starts from */
+    std::vector<std::vector<float>> m_ppfRotationStart;
+    unsigned m_nRampLength;
+    /** Samples of the current ramp already processed, m_nRampLength when done */
+    unsigned m_nRampPosition;
 };
 
 #endif // _AMBISONIC_PROCESSOR_H
@@ -13,6 +13,9 @@
 /*############################################################################*/
 
 
+#ifndef _AMBISONIC_PSYCHOACOUSTIC_FILTERS_H
+#define _AMBISONIC_PSYCHOACOUSTIC_FILTERS_H
+
 #include <cstdint>
 
 const int16_t first_order_3D[][101] =
@@ -58,3 +61,62 @@ const int16_t third_order_2D[][101] =
 {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,0,0,1,2,2,3,3,4,4,3,3,1,0,-2,-4,-6,-8,-10,-12,-14,-14,-14,-12,-10,-6,-1,5,12,20,29,38,47,56,64,71,77,82,84,15409,84,82,77,71,64,56,47,38,29,20,12,5,-1,-6,-10,-12,-14,-14,-14,-12,-10,-8,-6,-4,-2,0,1,3,3,4,4,3,3,2,2,1,0,0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
 {-2,-3,-4,-5,-6,-6,-7,-7,-7,-6,-4,-2,1,5,10,15,20,24,27,29,29,27,22,14,3,-10,-25,-42,-58,-74,-87,-97,-101,-99,-89,-71,-43,-7,39,92,151,215,282,350,415,475,528,572,605,625,8926,625,605,572,528,475,415,350,282,215,151,92,39,-7,-43,-71,-89,-99,-101,-97,-87,-74,-58,-42,-25,-10,3,14,22,27,29,29,27,24,20,15,10,5,1,-2,-4,-6,-7,-7,-7,-6,-6,-5,-4,-3,-2},
 };
+
+/** Minimum phase versions of the filters above, one row per order. They are
+    high shelf biquads fitted to the magnitude responses of the FIR filters
+    (within 0.5 dB), so have no latency. fGain is the low frequency gain,
+    fShelfGain the high frequency gain relative to it, fFrequency the shelf
+    frequency relative to the sample rate and nSections the number of
+    identical shelf sections in series, each with a share of fShelfGain. */
+struct PsychoacousticShelf
+{
+    float fGain;
+    float fShelfGain;
+    float fFrequency;
+    float fQ;
+    unsigned nSections;
+};
+
+const PsychoacousticShelf first_order_3D_iir[] =
+{
+    {1.0445f, 1.3569f, 0.01318f, 0.707f, 1},
+    {1.0242f, 0.7945f, 0.01445f, 0.707f, 1},
+};
+
+const PsychoacousticShelf second_order_3D_iir[] =
+{
+    {0.9939f, 1.5930f, 0.02512f, 0.800f, 2},
+    {0.9948f, 1.2324f, 0.02512f, 0.800f, 2},
+    {0.9961f, 0.6340f, 0.02754f, 0.900f, 1},
+};
+
+const PsychoacousticShelf third_order_3D_iir[] =
+{
+    {1.0009f, 1.6747f, 0.03631f, 1.000f, 1},
+    {1.0008f, 1.4421f, 0.03802f, 0.900f, 2},
+    {0.9995f, 1.0261f, 0.03467f, 0.800f, 1},
+    {0.9979f, 0.5104f, 0.03981f, 1.000f, 1},
+};
+
+const PsychoacousticShelf first_order_2D_iir[] =
+{
+    {1.0371f, 1.1806f, 0.01318f, 0.707f, 1},
+    {1.0252f, 0.8438f, 0.01445f, 0.707f, 1},
+};
+
+const PsychoacousticShelf second_order_2D_iir[] =
+{
+    {0.9945f, 1.2983f, 0.02512f, 0.800f, 2},
+    {0.9948f, 1.1242f, 0.02512f, 0.800f, 2},
+    {0.9957f, 0.6489f, 0.02754f, 0.900f, 1},
+};
+
+const PsychoacousticShelf third_order_2D_iir[] =
+{
+    {1.0006f, 1.3221f, 0.03802f, 0.900f, 2},
+    {0.9998f, 1.2222f, 0.03802f, 0.900f, 2},
+    {0.9998f, 0.9358f, 0.03981f, 1.000f, 1},
+    {0.9981f, 0.5073f, 0.03981f, 1.000f, 1},
+};
+
+#endif // _AMBISONIC_PSYCHOACOUSTIC_FILTERS_H
@@ -18,6 +18,7 @@
 #define _AMBISONIC_SOURCE_H
 
 #include "AmbisonicBase.h"
+#include "ParameterQueue.h"
 
 #include <vector>
 
@@ -53,6 +54,13 @@ public:
         Get azimuth, elevation, and distance settings.
     */
     virtual PolarPoint GetPosition();
+    /**
+        Set the position from a control thread while another thread calls
+        Process(). The position is applied, with a Refresh(), at the start of
+        the next Process(). If several are posted in between, only the last
+        one is applied. Only one thread may post.
+    */
+    void PostPosition(PolarPoint polPosition);
     /**
         Sets the weight [0,1] for the spherical harmonics of the given order.
     */
@@ -86,9 +94,17 @@ public:
 
 protected:
     std::vector<float> m_pfCoeff;
+    std::vector<float> m_pfNormalisation;
     std::vector<float> m_pfOrderWeights;
     PolarPoint m_polPosition;
     float m_fGain;
+    CParameterQueue<PolarPoint> m_PositionQueue;
+
+    /**
+        Apply the parameters posted since the last call. Returns true if any
+        changed, in which case Refresh() needs to be called.
+    */
+    virtual bool ApplyPostedParameters();
 };
 
 #endif // _AMBISONIC_SOURCE_H
@@ -20,18 +20,23 @@
 #include "AmbisonicBase.h"
 #include "AmbisonicDecoder.h"
 #include "BFormat.h"
+#include "ParameterQueue.h"
 
 #include <memory>
 
 /// Ambisonic zoomer.
 
-/** This object is used to apply a zoom effect into BFormat soundfields. */
+/** This object is used to apply a zoom effect into BFormat soundfields. It
+    owns its coefficient buffers and cannot be copied, configure a new one
+    instead. */
 
 class CAmbisonicZoomer : public CAmbisonicBase
 {
 public:
     CAmbisonicZoomer();
     virtual ~CAmbisonicZoomer() = default;
+    CAmbisonicZoomer(const CAmbisonicZoomer&) = delete;
+    CAmbisonicZoomer& operator = (const CAmbisonicZoomer&) = delete;
     /**
         Re-create the object for the given configuration. Previous data is
         lost. The last argument is not used, it is just there to match with
@@ -55,6 +60,13 @@ public:
         Get zoom factor.
     */
     float GetZoom();
+    /**
+        Set the zoom factor from a control thread while another thread calls
+        Process(). The value is applied, with a Refresh(), at the start of the
+        next Process(). If several are posted in between, only the last one is
+        applied. Only one thread may post.
+    */
+    void PostZoom(float fZoom);
     /**
         Zoom into B-Format stream.
     */
@@ -74,6 +86,7 @@ protected:
     float m_fZoomRed;
     float m_AmbFrontMic;
     float m_fZoomBlend;
+    CParameterQueue<float> m_ZoomQueue;
 };
 
 #endif // _AMBISONIC_ZOOMER_H
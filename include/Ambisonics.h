@@ -19,10 +19,12 @@
 #include "AmbisonicCommons.h"
 #include "AmbisonicBase.h"
 #include "BFormat.h"
+#include "BFormatView.h"
 #include "AmbisonicSource.h"
 #include "AmbisonicSpeaker.h"
 #include "AmbisonicMicrophone.h"
 #include "AmbisonicEncoder.h"
+#include "AmbisonicBatchEncoder.h"
 #include "AmbisonicEncoderDist.h"
 #include "AmbisonicDecoder.h"
 #include "AmbisonicProcessor.h"
@@ -17,6 +17,7 @@
 #define _BFORMAT_H
 
 #include "AmbisonicBase.h"
+#include "SampleConversion.h"
 #include <memory>
 #include <vector>
 
@@ -24,11 +25,22 @@
 
 /** This object is used to store and transfer BFormat signals. Memory is
     allocated for the number of channels needed for the given Ambisonic
-    configuration (order and 2D/3D) and the number of samples. */
+    configuration (order and 2D/3D) and the number of samples.
+
+    By default every channel starts on a 64-byte boundary and is padded to a
+    multiple of 16 samples, so channels never share a cache line and
+    vectorised loops can use aligned loads. This is not guaranteed for every
+    CBFormat: Configure() with an alignment of sizeof(float) packs the
+    channels without padding, and a CBFormatView has neither. Code that
+    relies on the alignment, or writes past the last sample of a channel,
+    must check GetAlignment() and GetChannelStride() first. */
 
 class CBFormat : public CAmbisonicBase
 {
 public:
+    /** Default channel alignment in bytes: one cache line, or an AVX-512 vector */
+    static const unsigned kDefaultAlignment = 64;
+
     CBFormat();
     CBFormat(const CBFormat& other);
 
@@ -37,10 +49,27 @@ public:
     */
     unsigned GetSampleCount();
     /**
-        Re-create the buffers needed for the given configuration. Previous
-        buffer contents are lost.
+        Returns the distance in samples between the starts of two consecutive
+        channels, i.e. the sample count plus the padding.
+    */
+    unsigned GetChannelStride();
+    /**
+        Returns the alignment in bytes of the start of every channel.
+    */
+    unsigned GetAlignment();
+    /**
+        Re-create the buffers needed for the given configuration, with
+        channels aligned to kDefaultAlignment. Previous buffer contents are
+        lost.
     */
     bool Configure(unsigned nOrder, bool b3D, unsigned nSampleCount);
+    /**
+        Re-create the buffers with every channel aligned to nAlignment bytes
+        and padded to a multiple of nAlignment. nAlignment must be a power of
+        two no smaller than sizeof(float); sizeof(float) packs the channels
+        back to back without padding.
+    */
+    bool Configure(unsigned nOrder, bool b3D, unsigned nSampleCount, unsigned nAlignment);
     /**
         Fill the buffer with zeros.
     */
@@ -57,6 +86,24 @@ public:
         Copy a number of samples from a specific channel of the BFormat.
     */
     void ExtractStream(float* pfData, unsigned nChannel, unsigned nSamples);
+    /**
+        Copy a number of frames of interleaved samples to all the channels in
+        one pass, converting integers to float as described in
+        SampleConversion.h. Channel n of frame i is read from
+        pfData[i * nFrameStride + n], so nFrameStride is at least the channel
+        count.
+    */
+    void InsertInterleaved(const float* pfData, unsigned nFrameStride, unsigned nSamples);
+    void InsertInterleaved(const int16_t* psData, unsigned nFrameStride, unsigned nSamples);
+    void InsertInterleaved(const int32_t* pnData, unsigned nFrameStride, unsigned nSamples);
+    /**
+        Copy a number of frames from all the channels to interleaved samples in
+        one pass, the reverse of InsertInterleaved(). pDither, if not null, is
+        added before the conversion to integers.
+    */
+    void ExtractInterleaved(float* pfData, unsigned nFrameStride, unsigned nSamples);
+    void ExtractInterleaved(int16_t* psData, unsigned nFrameStride, unsigned nSamples, CDither* pDither = nullptr);
+    void ExtractInterleaved(int32_t* pnData, unsigned nFrameStride, unsigned nSamples, CDither* pDither = nullptr);
 
     /**
         Copy the content of the buffer. It is assumed that the two objects are
@@ -82,6 +129,8 @@ public:
 
 protected:
     unsigned m_nSamples;
+    unsigned m_nStride;
+    unsigned m_nAlignment;
     unsigned m_nDataLength;
     std::vector<float> m_pfData;
     std::unique_ptr<float*[]> m_ppfChannels;
@@ -89,6 +138,7 @@ protected:
     //friend classes cannot be pure abstract type,
     //so must list each friend class manually
     friend class CAmbisonicEncoder;
+    friend class CAmbisonicBatchEncoder;
     friend class CAmbisonicEncoderDist;
     friend class CAmbisonicDecoder;
     friend class CAmbisonicSpeaker;
@@ -0,0 +1,69 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CBFormatView - Ambisonic BFormat View                                   #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      BFormatView.h                                            #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef _BFORMAT_VIEW_H
+#define _BFORMAT_VIEW_H
+
+#include "BFormat.h"
+
+/// BFormat view of externally owned channel buffers.
+
+/** A CBFormat that does not own any sample memory. It points at planar
+    channel buffers provided by the caller, e.g. the ones a plugin host passes
+    to its process callback, so that the encoders, processor, zoomer, decoders
+    and binauralizers read and write them in place instead of going through
+    InsertStream() and ExtractStream().
+
+    Configure() only allocates the table of channel pointers. SetChannels()
+    then points the view at the caller's buffers, it never allocates and can
+    be called from the audio thread for every block. The buffers must hold at
+    least the configured number of samples and stay valid while the view is
+    processed.
+
+    The kernels of the library need each channel to be contiguous. Interleaved
+    buffers have to be copied with InsertInterleaved() and
+    ExtractInterleaved(), which do it in a single pass for all the channels.
+
+    GetAlignment() returns the largest power of two, up to kDefaultAlignment,
+    that all the channel addresses are a multiple of. GetChannelStride()
+    returns 0 when the channels were given as separate pointers. */
+
+class CBFormatView : public CBFormat
+{
+public:
+    CBFormatView();
+    using CBFormat::operator=;
+
+    /**
+        Create the channel pointer table for the given configuration. The view
+        points at nothing until SetChannels() is called.
+    */
+    bool Configure(unsigned nOrder, bool b3D, unsigned nSampleCount);
+    /**
+        Zero the samples of the viewed buffers.
+    */
+    void Reset();
+    /**
+        Point the view at one buffer per channel, in ACN order.
+    */
+    void SetChannels(float* const* ppfChannels);
+    /**
+        Point the view at a single block holding the channels one after the
+        other, nChannelStride samples apart.
+    */
+    void SetChannels(float* pfData, unsigned nChannelStride);
+};
+
+#endif // _BFORMAT_VIEW_H
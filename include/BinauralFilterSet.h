@@ -0,0 +1,94 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CBinauralFilterSet - Shared Binaural Filters                            #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      BinauralFilterSet.h                                      #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef _BINAURAL_FILTER_SET_H
+#define _BINAURAL_FILTER_SET_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "fft.h"
+
+/// Frequency domain filters of a binauralizer.
+
+/** The spectra of the filters of both ears for every input channel, with all
+    the partitions of a filter one after the other. A set is filled once when
+    it is built and is then only read, so one set can be used by any number of
+    binauralizers at the same time. */
+
+class CBinauralFilterSet
+{
+public:
+    CBinauralFilterSet(unsigned nTaps, unsigned nFFTSize, unsigned nPartitions, unsigned nChannels);
+    /**
+        Spectra of one ear and channel, m_nPartitions * (m_nFFTSize / 2 + 1)
+        bins long.
+    */
+    kiss_fft_cpx* GetFilter(unsigned nEar, unsigned nChannel);
+    const kiss_fft_cpx* GetFilter(unsigned nEar, unsigned nChannel) const;
+    /**
+        Number of bins of one filter, all partitions included.
+    */
+    unsigned GetFilterSize() const;
+    unsigned GetTaps() const;
+    unsigned GetFFTSize() const;
+    unsigned GetPartitions() const;
+    unsigned GetChannelCount() const;
+
+protected:
+    unsigned m_nTaps;
+    unsigned m_nFFTSize;
+    unsigned m_nPartitions;
+    unsigned m_nChannels;
+    unsigned m_nFilterSize;
+    std::unique_ptr<kiss_fft_cpx[]> m_pcpFilters;
+};
+
+
+/// Process-wide registry of binaural filter sets.
+
+/** Binauralizers configured with the same HRTF and settings find the filter
+    set built by the first one here and share it instead of building their
+    own copy. The registry only holds weak references: a set is freed when
+    the last binauralizer using it is reconfigured or destroyed. All the
+    functions can be called from any thread. */
+
+class CBinauralFilterRegistry
+{
+public:
+    /**
+        The registry of the process.
+    */
+    static CBinauralFilterRegistry& GetInstance();
+    /**
+        Get the set registered for sKey, or nullptr if there is none.
+    */
+    std::shared_ptr<const CBinauralFilterSet> Find(const std::string& sKey);
+    /**
+        Register pFilters for sKey and return it. If another thread registered
+        a set for the same key in the meantime, that set is returned instead so
+        everyone shares one copy.
+    */
+    std::shared_ptr<const CBinauralFilterSet> Insert(const std::string& sKey,
+                                                     std::shared_ptr<const CBinauralFilterSet> pFilters);
+
+protected:
+    std::mutex m_mutex;
+    std::map<std::string, std::weak_ptr<const CBinauralFilterSet>> m_filterSets;
+};
+
+#endif // _BINAURAL_FILTER_SET_H
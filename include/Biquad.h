@@ -0,0 +1,62 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CBiquad - Second Order IIR Filter                                       #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      Biquad.h                                                 #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef _BIQUAD_H
+#define _BIQUAD_H
+
+/// Second order IIR filter section.
+
+/** Transposed direct form II biquad, used for the decoder crossovers and the
+    minimum phase shelf filters. The coefficients are normalised so that
+    a0 = 1. */
+
+class CBiquad
+{
+public:
+    CBiquad();
+    /**
+        Set the coefficients directly.
+    */
+    void SetCoefficients(float fB0, float fB1, float fB2, float fA1, float fA2);
+    /**
+        Second order Butterworth low-pass. Two in series make a 4th order
+        Linkwitz-Riley low-pass.
+    */
+    void SetLowPass(float fFrequency, float fSampleRate);
+    /**
+        Second order Butterworth high-pass. Two in series make a 4th order
+        Linkwitz-Riley high-pass.
+    */
+    void SetHighPass(float fFrequency, float fSampleRate);
+    /**
+        High shelf with linear gain fGain above fFrequency and unity gain
+        below it (RBJ cookbook).
+    */
+    void SetHighShelf(float fFrequency, float fSampleRate, float fGain, float fQ);
+    /**
+        Clear the filter state.
+    */
+    void Reset();
+    /**
+        Filter nSamples samples. pfSrc and pfDst may be the same buffer.
+    */
+    void Process(const float* pfSrc, float* pfDst, unsigned nSamples);
+
+protected:
+    float m_fB0, m_fB1, m_fB2, m_fA1, m_fA2;
+    float m_fZ1, m_fZ2;
+};
+
+#endif // _BIQUAD_H
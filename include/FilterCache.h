@@ -0,0 +1,103 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CFilterCache - Binaural Filter Cache                                    #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      FilterCache.h                                            #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef _FILTER_CACHE_H
+#define _FILTER_CACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BinauralFilterSet.h"
+
+/// On-disk cache of binaural filter spectra.
+
+/** Stores the frequency domain filters of a binauralizer so that a later
+    Configure() with the same HRTF, order, sample rate and block size can load
+    them instead of reading the HRTF and transforming the filters again.
+
+    Each entry is one file, named after a hash of its key. The file starts with
+    a header holding a format version, the key, the filter dimensions and a
+    checksum of the spectra, followed by the spectra themselves at a 64 byte
+    aligned offset, ear by ear and channel by channel. The file is memory
+    mapped where the platform allows it. An entry from another version, with a
+    different key or a wrong checksum is ignored. Files are written to a
+    temporary name and renamed so a reader never sees a partial entry. */
+
+class CFilterCache
+{
+public:
+    CFilterCache();
+    ~CFilterCache();
+    /**
+        Set the directory holding the cache files. It must already exist.
+        An empty string (the default) disables the cache.
+    */
+    void SetDirectory(const std::string& sDirectory);
+    /**
+        Get the cache directory.
+    */
+    std::string GetDirectory();
+    /**
+        Returns true if a cache directory is set.
+    */
+    bool IsEnabled();
+    /**
+        Open the entry stored for sKey. Returns false if there is none or if it
+        is not valid. The filters stay available until Close() is called.
+    */
+    bool Open(const std::string& sKey);
+    /**
+        Release the entry opened by Open().
+    */
+    void Close();
+    /**
+        Dimensions of the opened entry.
+    */
+    unsigned GetTaps();
+    unsigned GetFFTSize();
+    unsigned GetPartitions();
+    unsigned GetChannelCount();
+    /**
+        Spectra of the opened entry for one ear and channel, all the partitions
+        one after the other.
+    */
+    const kiss_fft_cpx* GetFilter(unsigned nEar, unsigned nChannel);
+    /**
+        Write the filters to the entry for sKey, replacing any previous one.
+        Returns true if successful.
+    */
+    bool Store(const std::string& sKey, const CBinauralFilterSet& filters);
+
+protected:
+    std::string m_sDirectory;
+
+    /** Start of the opened file and its size */
+    const unsigned char* m_pData;
+    size_t m_nDataSize;
+    /** Buffer holding the file when it cannot be memory mapped */
+    std::vector<unsigned char> m_pBuffer;
+    bool m_bMapped;
+
+    unsigned m_nTaps;
+    unsigned m_nFFTSize;
+    unsigned m_nPartitions;
+    unsigned m_nChannels;
+    const kiss_fft_cpx* m_pcpFilters;
+
+    std::string GetPath(const std::string& sKey);
+};
+
+#endif // _FILTER_CACHE_H
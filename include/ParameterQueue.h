@@ -0,0 +1,104 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CParameterQueue - Lock-Free Parameter Queue                             #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      ParameterQueue.h                                         #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef _PARAMETER_QUEUE_H
+#define _PARAMETER_QUEUE_H
+
+#include <atomic>
+#include <vector>
+
+/// Lock-free mailbox of parameter updates.
+
+/** Carries parameter values such as positions or orientations from one
+    control thread (a game engine, a head-tracker) to the audio thread. Only
+    the latest value matters, so it holds one value: a Push() replaces the
+    value not yet popped, and the audio thread never applies a stale one
+    however long it stalls. It is a triple buffer, one slot for each thread
+    and one exchanged between them with an atomic index: Push() is called by
+    one thread and PopLatest() by one other thread, and neither ever blocks
+    nor allocates. Several control threads must serialise their calls to
+    Push() themselves. */
+
+template<typename T>
+class CParameterQueue
+{
+public:
+    /**
+        Create an empty mailbox. value fills the slots, for types without a
+        default constructor.
+    */
+    explicit CParameterQueue(const T& value = T())
+        : m_pValues(3, value)
+        , m_nWriteSlot(0)
+        , m_nMiddleSlot(1)
+        , m_nReadSlot(2)
+    { }
+    /**
+        Copy the slots of other, but not its pending value: the copy starts
+        empty. This keeps the classes holding a mailbox copyable. Neither
+        thread may use other during the copy.
+    */
+    CParameterQueue(const CParameterQueue& other)
+        : m_pValues(other.m_pValues)
+        , m_nWriteSlot(0)
+        , m_nMiddleSlot(1)
+        , m_nReadSlot(2)
+    { }
+    CParameterQueue& operator = (const CParameterQueue& other)
+    {
+        m_pValues = other.m_pValues;
+        m_nWriteSlot = 0;
+        m_nMiddleSlot = 1;
+        m_nReadSlot = 2;
+        return *this;
+    }
+    /**
+        Post a value, replacing the one not yet popped if any.
+    */
+    void Push(const T& value)
+    {
+        m_pValues[m_nWriteSlot] = value;
+        unsigned nPrevious = m_nMiddleSlot.exchange(m_nWriteSlot | knNewValue, std::memory_order_acq_rel);
+        m_nWriteSlot = nPrevious & knSlotMask;
+    }
+    /**
+        Take the latest value pushed. Returns false if none was pushed since
+        the last call.
+    */
+    bool PopLatest(T& value)
+    {
+        if(!(m_nMiddleSlot.load(std::memory_order_relaxed) & knNewValue))
+            return false;
+        unsigned nPrevious = m_nMiddleSlot.exchange(m_nReadSlot, std::memory_order_acq_rel);
+        m_nReadSlot = nPrevious & knSlotMask;
+        value = m_pValues[m_nReadSlot];
+        return true;
+    }
+
+protected:
+    /** Flag set on m_nMiddleSlot when it holds a value not yet popped */
+    static const unsigned knNewValue = 4;
+    static const unsigned knSlotMask = 3;
+
+    std::vector<T> m_pValues;
+    /** Slot written by Push(), only used by the producer */
+    unsigned m_nWriteSlot;
+    /** Slot handed from one thread to the other */
+    std::atomic<unsigned> m_nMiddleSlot;
+    /** Slot read by PopLatest(), only used by the consumer */
+    unsigned m_nReadSlot;
+};
+
+#endif // _PARAMETER_QUEUE_H
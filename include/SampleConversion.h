@@ -0,0 +1,77 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  Interleaving and Sample Format Conversion                               #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      SampleConversion.h                                       #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef _SAMPLE_CONVERSION_H
+#define _SAMPLE_CONVERSION_H
+
+#include <cstdint>
+
+/** Conversion between interleaved frames and the planar float channels used
+    by the library. Decoders, network streams and sound cards carry frames of
+    16-bit or 32-bit integers or floats, one sample of every channel after the
+    other; these routines convert the format and (de)interleave in a single
+    pass, four frames by four channels at a time with SSE2 where available.
+
+    Integers map to [-1, 1) with a full scale of 2^15 for int16_t and 2^31 for
+    int32_t, so 24-bit samples are expected left-aligned in 32-bit words.
+    Conversion to integers rounds to the nearest value and saturates. The
+    frame stride is the distance in samples between two frames and may be
+    larger than the channel count. */
+
+/// Triangular probability density (TPDF) dither.
+
+/** Noise added to the float samples before they are rounded to integers, so
+    that the quantisation error is not correlated with the signal. Each object
+    holds its own noise generator, use one per output stream. */
+
+class CDither
+{
+public:
+    /**
+        nBits is the resolution of the output: 16 for int16_t, and usually 24
+        for int32_t words carrying 24-bit samples. nSeed selects the noise
+        sequence.
+    */
+    CDither(unsigned nBits = 16, unsigned nSeed = 1);
+    /**
+        Fill pfNoise with nSamples of noise spanning +/- one least significant
+        bit of the output, in the [-1, 1] scale of the float samples.
+    */
+    void Generate(float* pfNoise, unsigned nSamples);
+
+protected:
+    float m_fLSB;
+    uint32_t m_nState[16];
+};
+
+/**
+    Convert nSamples interleaved frames to nChannels planar float buffers:
+    ppfDst[c][i] is sample c of frame i.
+*/
+void Deinterleave(const float* pfSrc, unsigned nFrameStride, float* const* ppfDst, unsigned nChannels, unsigned nSamples);
+void Deinterleave(const int16_t* psSrc, unsigned nFrameStride, float* const* ppfDst, unsigned nChannels, unsigned nSamples);
+void Deinterleave(const int32_t* pnSrc, unsigned nFrameStride, float* const* ppfDst, unsigned nChannels, unsigned nSamples);
+
+/**
+    Convert nChannels planar float buffers to nSamples interleaved frames,
+    e.g. the speaker feeds of a decoder or the two ears of a binauralizer.
+    The samples of the frames beyond nChannels are left untouched. pDither,
+    if not null, is added before the conversion to integers.
+*/
+void Interleave(const float* const* ppfSrc, unsigned nChannels, unsigned nSamples, float* pfDst, unsigned nFrameStride);
+void Interleave(const float* const* ppfSrc, unsigned nChannels, unsigned nSamples, int16_t* psDst, unsigned nFrameStride, CDither* pDither = nullptr);
+void Interleave(const float* const* ppfSrc, unsigned nChannels, unsigned nSamples, int32_t* pnDst, unsigned nFrameStride, CDither* pDither = nullptr);
+
+#endif // _SAMPLE_CONVERSION_H
@@ -23,11 +23,27 @@ public:
                    std::string HRTFPath = "");
 
     void Process(float** pBFSrc, float** ppfDst);
+    /**
+        Binauralize nSamples of the speaker feeds, for any nSamples. As with
+        CAmbisonicBinauralizer, the output is delayed by nBlockSize samples.
+        Do not mix with the Process() above on the same object.
+    */
+    void Process(float** ppfSrc, float** ppfDst, unsigned nSamples);
+    /**
+        Not supported, the speaker layout can only be changed by Configure().
+        Returns false.
+    */
+    bool ConfigureAsync(unsigned nOrder,
+                        bool b3D,
+                        unsigned nSampleRate,
+                        unsigned nBlockSize,
+                        std::string HRTFPath = "",
+                        bool bCrossfade = false);
 
 protected:
     unsigned m_nSpeakers;
 
-    virtual void AllocateBuffers();
+    void ProcessFifoBlock(float** ppfDst);
 };
 
 #endif // BINAURALIZER_H
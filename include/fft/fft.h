@@ -0,0 +1,54 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  FFT - Real FFT Interface                                                #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      fft.h                                                    #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef FFT_H
+#define FFT_H
+
+#include "kiss_fft.h"
+
+
+/** Real FFT of a fixed size. The spectra use the kiss_fft_cpx layout (interleaved
+    real and imaginary parts) and hold getSize() / 2 + 1 bins, whatever the
+    backend. The backend is chosen when the library is configured with CMake
+    (FFT_BACKEND), the bundled kiss_fft is always available as a fallback. */
+class FFT
+{
+public:
+    FFT(unsigned i_size)
+        : i_size(i_size), b_ready(false)
+    { }
+    virtual ~FFT() = default;
+
+    /** Forward transform of getSize() samples to getSize() / 2 + 1 bins. */
+    virtual void forward(const float* pfTime, kiss_fft_cpx* pcpFreq) = 0;
+    /** Inverse transform of getSize() / 2 + 1 bins to getSize() samples. The
+        result is not normalised, it must be scaled by 1 / getSize(). */
+    virtual void inverse(const kiss_fft_cpx* pcpFreq, float* pfTime) = 0;
+
+    bool isReady() { return b_ready; }
+    unsigned getSize() { return i_size; }
+
+protected:
+    unsigned i_size;
+    bool b_ready;
+};
+
+/** Returns a transform of size i_size using the configured backend. If the
+    backend cannot handle this size the bundled kiss_fft is used instead.
+    Returns nullptr if no transform could be created. */
+FFT* createFFT(unsigned i_size);
+
+
+#endif // FFT_H
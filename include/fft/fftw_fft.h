@@ -0,0 +1,43 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  FFTW_FFT - FFTW Backend                                                 #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      fftw_fft.h                                               #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef FFTW_FFT_H
+#define FFTW_FFT_H
+
+#include "config.h"
+
+#ifdef HAVE_FFTW
+
+#include <fftw3.h>
+
+#include "fft.h"
+
+
+class FFTW_FFT : public FFT
+{
+public:
+    FFTW_FFT(unsigned i_size);
+    ~FFTW_FFT();
+    void forward(const float* pfTime, kiss_fft_cpx* pcpFreq);
+    void inverse(const kiss_fft_cpx* pcpFreq, float* pfTime);
+
+private:
+    fftwf_plan forwardPlan;
+    fftwf_plan inversePlan;
+};
+
+#endif
+
+#endif // FFTW_FFT_H
@@ -0,0 +1,37 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  KISS_FFT - kiss_fft Backend                                             #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      kissfft_fft.h                                            #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef KISSFFT_FFT_H
+#define KISSFFT_FFT_H
+
+#include "fft.h"
+#include "kiss_fftr.h"
+
+
+class KISS_FFT : public FFT
+{
+public:
+    KISS_FFT(unsigned i_size);
+    ~KISS_FFT();
+    void forward(const float* pfTime, kiss_fft_cpx* pcpFreq);
+    void inverse(const kiss_fft_cpx* pcpFreq, float* pfTime);
+
+private:
+    kiss_fftr_cfg forwardCfg;
+    kiss_fftr_cfg inverseCfg;
+};
+
+
+#endif // KISSFFT_FFT_H
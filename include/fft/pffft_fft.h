@@ -0,0 +1,46 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  PFFFT_FFT - PFFFT Backend                                               #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      pffft_fft.h                                              #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef PFFFT_FFT_H
+#define PFFFT_FFT_H
+
+#include "config.h"
+
+#ifdef HAVE_PFFFT
+
+#include <pffft.h>
+
+#include "fft.h"
+
+
+class PFFFT_FFT : public FFT
+{
+public:
+    PFFFT_FFT(unsigned i_size);
+    ~PFFFT_FFT();
+    void forward(const float* pfTime, kiss_fft_cpx* pcpFreq);
+    void inverse(const kiss_fft_cpx* pcpFreq, float* pfTime);
+
+private:
+    PFFFT_Setup *setup;
+    /** PFFFT needs SIMD aligned buffers */
+    float *pfIn;
+    float *pfOut;
+    float *pfWork;
+};
+
+#endif
+
+#endif // PFFFT_FFT_H
@@ -0,0 +1,46 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  POCKETFFT_FFT - pocketfft Backend                                       #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      pocketfft_fft.h                                          #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef POCKETFFT_FFT_H
+#define POCKETFFT_FFT_H
+
+#include "config.h"
+
+#ifdef HAVE_POCKETFFT
+
+#include <memory>
+#include <vector>
+
+#include "fft.h"
+
+namespace pocketfft { namespace detail { template<typename T0> class pocketfft_r; } }
+
+
+class POCKETFFT_FFT : public FFT
+{
+public:
+    POCKETFFT_FFT(unsigned i_size);
+    ~POCKETFFT_FFT();
+    void forward(const float* pfTime, kiss_fft_cpx* pcpFreq);
+    void inverse(const kiss_fft_cpx* pcpFreq, float* pfTime);
+
+private:
+    std::unique_ptr<pocketfft::detail::pocketfft_r<float>> plan;
+    std::vector<float> pfBuffer;
+};
+
+#endif
+
+#endif // POCKETFFT_FFT_H
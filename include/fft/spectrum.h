@@ -0,0 +1,52 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  Complex Multiply-Accumulate Kernels                                     #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      spectrum.h                                               #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <vector>
+
+#include "kiss_fft.h"
+
+
+/** Complex products of spectra, used by all the frequency domain convolutions.
+    They work on the interleaved kiss_fft_cpx layout given by every FFT
+    backend. The SSE2, AVX2/FMA or NEON version is picked once at run time
+    depending on the CPU, with a plain C version as the fallback. */
+
+/** pcpDst[i] = pcpA[i] * pcpB[i] for nBins bins. pcpDst may be pcpA or pcpB. */
+void spectrumMultiply(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins);
+
+/** pcpDst[i] += pcpA[i] * pcpB[i] for nBins bins. */
+void spectrumMultiplyAccumulate(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins);
+
+/** Name of the version in use: "c", "sse2", "avx2" or "neon". */
+const char* spectrumKernelName();
+
+typedef void (*SpectrumFunction)(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins);
+
+struct SpectrumKernel
+{
+    const char* name;
+    SpectrumFunction multiply;
+    SpectrumFunction multiplyAccumulate;
+};
+
+/** Every version compiled in and supported by the CPU, from the plain C one
+    to the one in use, so that the tests can check each of them. */
+std::vector<SpectrumKernel> spectrumKernels();
+
+
+#endif // SPECTRUM_H
@@ -1,6 +1,8 @@
 #ifndef MIT_HRTF_H
 #define MIT_HRTF_H
 
+#include <vector>
+
 #include "hrtf.h"
 
 #ifdef HAVE_MIT_HRTF
@@ -10,6 +12,10 @@ class MIT_HRTF : public HRTF
 public:
     MIT_HRTF(unsigned i_sampleRate);
     bool get(float f_azimuth, float f_elevation, float **pfHRTF);
+
+private:
+    /** Taps as stored in the library, allocated once for all the get() calls */
+    std::vector<short> psHRTF[2];
 };
 
 #endif
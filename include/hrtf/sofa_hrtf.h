@@ -6,6 +6,7 @@
 #ifdef HAVE_MYSOFA
 
 #include <string>
+#include <vector>
 
 #include <mysofa.h>
 
@@ -24,6 +25,8 @@ private:
 
     unsigned i_filterExtraLength;
     int i_internalLength;
+    /** Filters before the delays are applied, allocated once for all the get() calls */
+    std::vector<float> pfHRTFNotDelayed[2];
 };
 
 #endif
@@ -0,0 +1,100 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CAmbisonicBatchEncoder - Ambisonic Batch Encoder                        #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      AmbisonicBatchEncoder.cpp                                #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "AmbisonicBatchEncoder.h"
+
+
+CAmbisonicBatchEncoder::CAmbisonicBatchEncoder()
+    : m_nSources(0)
+{ }
+
+CAmbisonicBatchEncoder::~CAmbisonicBatchEncoder()
+{ }
+
+bool CAmbisonicBatchEncoder::Configure(unsigned nOrder, bool b3D, unsigned nSources)
+{
+    bool success = CAmbisonicBase::Configure(nOrder, b3D, nSources);
+    if(!success)
+        return false;
+
+    m_nSources = nSources;
+    PolarPoint polDefault = {0.f, 0.f, 1.f};
+    m_polPositions.assign(m_nSources, polDefault);
+    m_pfGains.assign(m_nSources, 1.f);
+    m_pbDirty.assign(m_nSources, true);
+    m_pfCoeff.assign(m_nChannelCount * m_nSources, 0.f);
+    m_pfSourceCoeff.resize(m_nChannelCount);
+
+    // Uses ACN channel ordering and SN3D normalization scheme (AmbiX format) for 3D
+    m_pfNormalisation.resize(m_nChannelCount);
+    SphericalHarmonicNormalisation(m_nOrder, m_b3D, kSN3D, m_pfNormalisation.data());
+
+    Refresh();
+
+    return true;
+}
+
+void CAmbisonicBatchEncoder::Reset()
+{
+}
+
+void CAmbisonicBatchEncoder::Refresh()
+{
+    for(unsigned niSource = 0; niSource < m_nSources; niSource++)
+    {
+        if(!m_pbDirty[niSource])
+            continue;
+
+        SphericalHarmonics(m_nOrder, m_b3D, m_polPositions[niSource].fAzimuth, m_polPositions[niSource].fElevation,
+                           m_pfNormalisation.data(), m_pfSourceCoeff.data());
+        for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+            m_pfCoeff[niChannel * m_nSources + niSource] = m_pfSourceCoeff[niChannel] * m_pfGains[niSource];
+
+        m_pbDirty[niSource] = false;
+    }
+}
+
+unsigned CAmbisonicBatchEncoder::GetSourceCount()
+{
+    return m_nSources;
+}
+
+void CAmbisonicBatchEncoder::SetPosition(unsigned nSource, PolarPoint polPosition)
+{
+    m_polPositions[nSource] = polPosition;
+    m_pbDirty[nSource] = true;
+}
+
+PolarPoint CAmbisonicBatchEncoder::GetPosition(unsigned nSource)
+{
+    return m_polPositions[nSource];
+}
+
+void CAmbisonicBatchEncoder::SetGain(unsigned nSource, float fGain)
+{
+    m_pfGains[nSource] = fGain;
+    m_pbDirty[nSource] = true;
+}
+
+float CAmbisonicBatchEncoder::GetGain(unsigned nSource)
+{
+    return m_pfGains[nSource];
+}
+
+void CAmbisonicBatchEncoder::Process(float** ppfSrc, unsigned nSamples, CBFormat* pBFDst)
+{
+    // The mix is a (channels x sources) by (sources x samples) matrix product
+    MatrixMix(m_pfCoeff.data(), m_nChannelCount, m_nSources, ppfSrc, pBFDst->m_ppfChannels.get(), nSamples);
+}
@@ -16,14 +16,14 @@
 
 #include "config.h"
 
-#include <iostream>
+#include <algorithm>
+#include <system_error>
+#include <sys/stat.h>
 
 #include "AmbisonicBinauralizer.h"
 
 
 CAmbisonicBinauralizer::CAmbisonicBinauralizer()
-    : m_pFFT_cfg(nullptr, kiss_fftr_free)
-    , m_pIFFT_cfg(nullptr, kiss_fftr_free)
 {
     m_nBlockSize = 0;
     m_nTaps = 0;
@@ -31,6 +31,26 @@ CAmbisonicBinauralizer::CAmbisonicBinauralizer()
     m_nFFTBins = 0;
     m_fFFTScaler = 0.f;
     m_nOverlapLength = 0;
+    m_nPartitions = 1;
+    m_nFDLPosition = 0;
+    m_bLowCPU = false;
+    m_bConfigureSuccess = false;
+    m_nConfigureTailLength = 0;
+    m_nConfigureRequest = 0;
+    m_nConfigureDone = 0;
+    m_nConfigureId = 0;
+    m_pNextConfiguration = nullptr;
+    m_pWaitingConfiguration = nullptr;
+    m_pRetiredConfigurations = nullptr;
+    m_pNextRetired = nullptr;
+    m_bCrossfade = false;
+    m_nFifoPosition = 0;
+}
+
+CAmbisonicBinauralizer::~CAmbisonicBinauralizer()
+{
+    DiscardConfigure();
+    delete m_pWaitingConfiguration;
 }
 
 bool CAmbisonicBinauralizer::Configure(unsigned nOrder,
@@ -46,25 +66,49 @@ bool CAmbisonicBinauralizer::Configure(unsigned nOrder,
     unsigned niSpeaker = 0;
     unsigned niTap = 0;
 
+    //Drop any configuration requested with ConfigureAsync()
+    DiscardConfigure();
+    delete m_pWaitingConfiguration;
+    m_pWaitingConfiguration = nullptr;
+    m_nConfigureDone = m_nConfigureRequest.load();
+
+    m_nBlockSize = nBlockSize;
+    CAmbisonicBase::Configure(nOrder, b3D, 0);
+
+    //Mirroring the soundfield left to right negates the components that are odd in azimuth (sin(m*azimuth)).
+    //In ACN order these are the channels with degree m < 0. In 2D they are every second channel from channel 2.
+    m_pfSymmetrySign.resize(m_nChannelCount);
+    for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    {
+        bool bOdd;
+        if(m_b3D)
+        {
+            int nOrder = (int)sqrt((float)niChannel);
+            bOdd = (int)niChannel - nOrder * nOrder - nOrder < 0;
+        }
+        else
+            bOdd = niChannel > 0 && niChannel % 2 == 0;
+        m_pfSymmetrySign[niChannel] = bOdd ? -1.f : 1.f;
+    }
+
+    //Use the filters of another binauralizer or of the cache if this configuration was seen before
+    std::string sFilterKey = GetHRTFKey(nSampleRate, HRTFPath);
+    if(!sFilterKey.empty())
+        sFilterKey = "ambisonic " + sFilterKey
+            + " order=" + std::to_string(m_nOrder)
+            + " 3d=" + std::to_string(m_b3D ? 1 : 0)
+            + " block=" + std::to_string(m_nBlockSize);
+    if(FindFilters(sFilterKey, tailLength))
+        return true;
+
     HRTF *p_hrtf = getHRTF(nSampleRate, HRTFPath);
     if (p_hrtf == nullptr)
         return false;
 
     tailLength = m_nTaps = p_hrtf->getHRTFLen();
-    m_nBlockSize = nBlockSize;
 
-    //What will the overlap size be?
-    m_nOverlapLength = m_nBlockSize < m_nTaps ? m_nBlockSize - 1 : m_nTaps - 1;
-    //How large does the FFT need to be
-    m_nFFTSize = 1;
-    while(m_nFFTSize < (m_nBlockSize + m_nTaps + m_nOverlapLength))
-        m_nFFTSize <<= 1;
-    //How many bins is that
-    m_nFFTBins = m_nFFTSize / 2 + 1;
-    //What do we need to scale the result of the iFFT by
-    m_fFFTScaler = 1.f / m_nFFTSize;
+    ConfigureFFTSize();
 
-    CAmbisonicBase::Configure(nOrder, b3D, 0);
     //Position speakers and recalculate coefficients
     ArrangeSpeakers();
 
@@ -72,6 +116,7 @@ bool CAmbisonicBinauralizer::Configure(unsigned nOrder,
 
     //Allocate buffers with new settings
     AllocateBuffers();
+    std::shared_ptr<CBinauralFilterSet> pFilters = std::make_shared<CBinauralFilterSet>(m_nTaps, m_nFFTSize, m_nPartitions, m_nChannelCount);
 
     //Allocate temporary buffers for retrieving taps from mit_hrtf_lib
     float* pfHRTF[2];
@@ -164,11 +209,7 @@ bool CAmbisonicBinauralizer::Configure(unsigned nOrder,
     for(niEar = 0; niEar < 2; niEar++)
     {
         for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
-        {
-            memcpy(m_pfScratchBufferA.data(), ppfAccumulator[niEar][niChannel], m_nTaps * sizeof(float));
-            memset(&m_pfScratchBufferA[m_nTaps], 0, (m_nFFTSize - m_nTaps) * sizeof(float));
-            kiss_fftr(m_pFFT_cfg.get(), m_pfScratchBufferA.data(), m_ppcpFilters[niEar][niChannel].get());
-        }
+            ConvertFilter(ppfAccumulator[niEar][niChannel], pFilters->GetFilter(niEar, niChannel));
     }
 
     for(niEar = 0; niEar < 2; niEar++)
@@ -182,6 +223,162 @@ bool CAmbisonicBinauralizer::Configure(unsigned nOrder,
     }
     delete[] pfLeftEar90;
 
+    ShareFilters(sFilterKey, pFilters);
+
+    return true;
+}
+
+bool CAmbisonicBinauralizer::ConfigureAsync(unsigned nOrder,
+                                            bool b3D,
+                                            unsigned nSampleRate,
+                                            unsigned nBlockSize,
+                                            std::string HRTFPath,
+                                            bool bCrossfade)
+{
+    DiscardConfigure();
+
+    //Process() drops a configuration it was waiting to switch to as soon as the request number changes
+    unsigned nId = m_nConfigureRequest.load() + 1;
+    m_nConfigureRequest = nId;
+    m_bConfigureSuccess = false;
+
+    CAmbisonicBinauralizer* pNext = new CAmbisonicBinauralizer();
+    pNext->SetFilterCacheDirectory(GetFilterCacheDirectory());
+    pNext->m_nConfigureId = nId;
+    pNext->m_bCrossfade = bCrossfade;
+
+    try
+    {
+        m_ConfigureThread = std::thread([=]()
+        {
+            unsigned nTailLength = 0;
+            bool bSuccess = pNext->Configure(nOrder, b3D, nSampleRate, nBlockSize, nTailLength, HRTFPath);
+            m_bConfigureSuccess = bSuccess;
+            m_nConfigureTailLength = nTailLength;
+            FreeRetiredConfigurations();
+            if(bSuccess)
+            {
+                if(bCrossfade)
+                {
+                    pNext->m_pfCrossfade[0].resize(nBlockSize);
+                    pNext->m_pfCrossfade[1].resize(nBlockSize);
+                }
+                delete m_pNextConfiguration.exchange(pNext, std::memory_order_acq_rel);
+            }
+            else
+            {
+                delete pNext;
+                m_nConfigureDone = nId;
+            }
+        });
+    }
+    catch(const std::system_error&)
+    {
+        delete pNext;
+        m_nConfigureDone = nId;
+        return false;
+    }
+
+    return true;
+}
+
+bool CAmbisonicBinauralizer::WaitForConfigure(unsigned& tailLength)
+{
+    if(m_ConfigureThread.joinable())
+        m_ConfigureThread.join();
+    if(m_bConfigureSuccess)
+        tailLength = m_nConfigureTailLength;
+    return m_bConfigureSuccess;
+}
+
+bool CAmbisonicBinauralizer::IsConfigurePending()
+{
+    return m_nConfigureDone != m_nConfigureRequest;
+}
+
+void CAmbisonicBinauralizer::CollectGarbage()
+{
+    FreeRetiredConfigurations();
+}
+
+void CAmbisonicBinauralizer::DiscardConfigure()
+{
+    if(m_ConfigureThread.joinable())
+        m_ConfigureThread.join();
+    delete m_pNextConfiguration.exchange(nullptr, std::memory_order_acq_rel);
+    FreeRetiredConfigurations();
+}
+
+void CAmbisonicBinauralizer::RetireConfiguration(CAmbisonicBinauralizer* pConfiguration)
+{
+    pConfiguration->m_pNextRetired = m_pRetiredConfigurations.load(std::memory_order_relaxed);
+    while(!m_pRetiredConfigurations.compare_exchange_weak(pConfiguration->m_pNextRetired, pConfiguration,
+                                                          std::memory_order_release, std::memory_order_relaxed))
+        ;
+}
+
+void CAmbisonicBinauralizer::FreeRetiredConfigurations()
+{
+    CAmbisonicBinauralizer* pConfiguration = m_pRetiredConfigurations.exchange(nullptr, std::memory_order_acquire);
+    while(pConfiguration)
+    {
+        CAmbisonicBinauralizer* pNextRetired = pConfiguration->m_pNextRetired;
+        delete pConfiguration;
+        pConfiguration = pNextRetired;
+    }
+}
+
+bool CAmbisonicBinauralizer::IsFormatOf(CBFormat* pBFSrc)
+{
+    return m_pFilters && pBFSrc->GetOrder() == m_nOrder && pBFSrc->GetHeight() == m_b3D
+        && pBFSrc->GetSampleCount() == m_nBlockSize;
+}
+
+void CAmbisonicBinauralizer::SwapConfiguration(CAmbisonicBinauralizer& other)
+{
+    //m_AmbDecoder is only used while configuring and is left as it is
+    std::swap(m_nOrder, other.m_nOrder);
+    std::swap(m_b3D, other.m_b3D);
+    std::swap(m_nChannelCount, other.m_nChannelCount);
+    std::swap(m_bOpt, other.m_bOpt);
+    std::swap(m_nBlockSize, other.m_nBlockSize);
+    std::swap(m_nTaps, other.m_nTaps);
+    std::swap(m_nFFTSize, other.m_nFFTSize);
+    std::swap(m_nFFTBins, other.m_nFFTBins);
+    std::swap(m_fFFTScaler, other.m_fFFTScaler);
+    std::swap(m_nOverlapLength, other.m_nOverlapLength);
+    std::swap(m_nPartitions, other.m_nPartitions);
+    std::swap(m_nFDLPosition, other.m_nFDLPosition);
+    m_pFFT.swap(other.m_pFFT);
+    m_pFilters.swap(other.m_pFilters);
+    m_pcpScratch.swap(other.m_pcpScratch);
+    m_pcpAccumulator[0].swap(other.m_pcpAccumulator[0]);
+    m_pcpAccumulator[1].swap(other.m_pcpAccumulator[1]);
+    m_ppcpFDL.swap(other.m_ppcpFDL);
+    m_pfSymmetrySign.swap(other.m_pfSymmetrySign);
+    m_pfScratchBufferA.swap(other.m_pfScratchBufferA);
+    m_pfScratchBufferB.swap(other.m_pfScratchBufferB);
+    m_pfOverlap[0].swap(other.m_pfOverlap[0]);
+    m_pfOverlap[1].swap(other.m_pfOverlap[1]);
+    m_ppfInputHistory.swap(other.m_ppfInputHistory);
+}
+
+bool CAmbisonicBinauralizer::CopyInputState(const CAmbisonicBinauralizer& other)
+{
+    if(m_nChannelCount != other.m_nChannelCount || m_nBlockSize != other.m_nBlockSize
+       || m_nFFTSize != other.m_nFFTSize || m_nPartitions != other.m_nPartitions
+       || m_nOverlapLength != other.m_nOverlapLength || m_ppcpFDL.size() != other.m_ppcpFDL.size())
+        return false;
+
+    for(unsigned niChannel = 0; niChannel < m_ppcpFDL.size(); niChannel++)
+    {
+        memcpy(m_ppfInputHistory[niChannel].data(), other.m_ppfInputHistory[niChannel].data(), m_nFFTSize * sizeof(float));
+        memcpy(m_ppcpFDL[niChannel].get(), other.m_ppcpFDL[niChannel].get(), m_nPartitions * m_nFFTBins * sizeof(kiss_fft_cpx));
+    }
+    m_nFDLPosition = other.m_nFDLPosition;
+    memcpy(m_pfOverlap[0].data(), other.m_pfOverlap[0].data(), m_nOverlapLength * sizeof(float));
+    memcpy(m_pfOverlap[1].data(), other.m_pfOverlap[1].data(), m_nOverlapLength * sizeof(float));
+
     return true;
 }
 
@@ -189,6 +386,19 @@ void CAmbisonicBinauralizer::Reset()
 {
     memset(m_pfOverlap[0].data(), 0, m_nOverlapLength * sizeof(float));
     memset(m_pfOverlap[1].data(), 0, m_nOverlapLength * sizeof(float));
+
+    for(unsigned niChannel = 0; niChannel < m_ppfInputHistory.size(); niChannel++)
+    {
+        memset(m_ppfInputHistory[niChannel].data(), 0, m_nFFTSize * sizeof(float));
+        memset(m_ppcpFDL[niChannel].get(), 0, m_nPartitions * m_nFFTBins * sizeof(kiss_fft_cpx));
+    }
+    m_nFDLPosition = 0;
+
+    for(unsigned niChannel = 0; niChannel < m_ppfInputFifo.size(); niChannel++)
+        memset(m_ppfInputFifo[niChannel].data(), 0, m_ppfInputFifo[niChannel].size() * sizeof(float));
+    memset(m_pfOutputFifo[0].data(), 0, m_pfOutputFifo[0].size() * sizeof(float));
+    memset(m_pfOutputFifo[1].data(), 0, m_pfOutputFifo[1].size() * sizeof(float));
+    m_nFifoPosition = 0;
 }
 
 void CAmbisonicBinauralizer::Refresh()
@@ -199,17 +409,48 @@ void CAmbisonicBinauralizer::Refresh()
 void CAmbisonicBinauralizer::Process(CBFormat* pBFSrc,
                                      float** ppfDst)
 {
-    unsigned niEar = 0;
-    unsigned niChannel = 0;
-    unsigned ni = 0;
-    kiss_fft_cpx cpTemp;
-
+    //Switch to a configuration built by ConfigureAsync() once the input is in its format. The state it
+    //replaces is kept for this block when fading and then retired to be freed off the audio thread.
+    CAmbisonicBinauralizer* pPrevious = nullptr;
+    if(m_pNextConfiguration.load(std::memory_order_relaxed))
+    {
+        CAmbisonicBinauralizer* pNext = m_pNextConfiguration.exchange(nullptr, std::memory_order_acq_rel);
+        if(pNext && m_pWaitingConfiguration)
+            RetireConfiguration(m_pWaitingConfiguration);
+        if(pNext)
+            m_pWaitingConfiguration = pNext;
+    }
+    if(m_pWaitingConfiguration)
+    {
+        CAmbisonicBinauralizer* pNext = m_pWaitingConfiguration;
+        if(pNext->m_nConfigureId != m_nConfigureRequest.load(std::memory_order_acquire))
+        {
+            //A newer configuration was requested
+            RetireConfiguration(pNext);
+            m_pWaitingConfiguration = nullptr;
+        }
+        else if(pNext->IsFormatOf(pBFSrc))
+        {
+            bool bCrossfade = pNext->m_bCrossfade && IsFormatOf(pBFSrc);
+            //When only the filters change, the new configuration goes on from the input already in the delay
+            //lines, otherwise it would miss the tail of the partitions still to come. Both then share it when fading.
+            pNext->CopyInputState(*this);
+            SwapConfiguration(*pNext);
+            m_pWaitingConfiguration = nullptr;
+            m_nConfigureDone = pNext->m_nConfigureId;
+            if(bCrossfade)
+                pPrevious = pNext;
+            else
+                RetireConfiguration(pNext);
+        }
+    }
 
     /* If CPU load needs to be reduced then perform the convolution for each of the Ambisonics/spherical harmonic
     decompositions of the loudspeakers HRTFs for the left ear. For the left ear the results of these convolutions
     are summed to give the ear signal. For the right ear signal, the properties of the spherical harmonic decomposition
     can be use to to create the ear signal. This is done by either adding or subtracting the correct channels.
-    Channels 1, 4, 5, 9, 10 and 11 are subtracted from the accumulated signal. All others are added.
+    Channels that change sign when the soundfield is mirrored left to right (see m_pfSymmetrySign) are subtracted
+    from the accumulated signal. All others are added.
     For example, for a first order signal the ears are generated from:
         SignalL = W x HRTF_W + Y x HRTF_Y + Z x HRTF_Z + X x HRTF_X
         SignalR = W x HRTF_W - Y x HRTF_Y + Z x HRTF_Z + X x HRTF_X
@@ -217,88 +458,208 @@ void CAmbisonicBinauralizer::Process(CBFormat* pBFSrc,
     decompositions of the virtual loudspeaker array HRTFs.
     This has the effect of assuming a completel symmetric head. */
 
-    /* TODO: This bool flag should be either an automatic or user option depending on CPU. It should be 'true' if
-    CPU load needs to be limited */
-    bool bLowCPU = false;
-    if(bLowCPU){
-        // Perform the convolutions for the left ear and generate the right ear from a modified accumulation of these channels
-        niEar = 0;
-        memset(m_pfScratchBufferA.data(), 0, m_nFFTSize * sizeof(float));
-        memset(m_pfScratchBufferC.data(), 0, m_nFFTSize * sizeof(float));
-        for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    ProcessConvolution(pBFSrc->m_ppfChannels.get(), ppfDst, m_bLowCPU);
+
+    if(pPrevious)
+    {
+        //Fade linearly from the output of the previous filters to the new ones over the block
+        float* ppfPrevious[2] = {pPrevious->m_pfCrossfade[0].data(), pPrevious->m_pfCrossfade[1].data()};
+        pPrevious->ProcessConvolution(pBFSrc->m_ppfChannels.get(), ppfPrevious, m_bLowCPU);
+        float fStep = 1.f / m_nBlockSize;
+        for(unsigned niEar = 0; niEar < 2; niEar++)
+            for(unsigned ni = 0; ni < m_nBlockSize; ni++)
+                ppfDst[niEar][ni] = ppfPrevious[niEar][ni] + (ni + 1) * fStep * (ppfDst[niEar][ni] - ppfPrevious[niEar][ni]);
+        RetireConfiguration(pPrevious);
+    }
+}
+
+void CAmbisonicBinauralizer::Process(CBFormat* pBFSrc,
+                                     float** ppfDst,
+                                     unsigned nSamples)
+{
+    ProcessBuffered(pBFSrc->m_ppfChannels.get(), ppfDst, nSamples);
+}
+
+void CAmbisonicBinauralizer::ProcessBuffered(float* const* ppfSrc, float** ppfDst, unsigned nSamples)
+{
+    if(m_nBlockSize == 0)
+        return;
+
+    unsigned niSample = 0;
+    while(niSample < nSamples)
+    {
+        unsigned nCopy = std::min(m_nBlockSize - m_nFifoPosition, nSamples - niSample);
+        for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+            memcpy(&m_ppfInputFifo[niChannel][m_nFifoPosition], &ppfSrc[niChannel][niSample], nCopy * sizeof(float));
+        for(unsigned niEar = 0; niEar < 2; niEar++)
+            memcpy(&ppfDst[niEar][niSample], &m_pfOutputFifo[niEar][m_nFifoPosition], nCopy * sizeof(float));
+        m_nFifoPosition += nCopy;
+        niSample += nCopy;
+
+        //Convolve a block as soon as it is complete. Its output is read out while the next one comes in.
+        if(m_nFifoPosition == m_nBlockSize)
+        {
+            float* ppfFifoDst[2] = {m_pfOutputFifo[0].data(), m_pfOutputFifo[1].data()};
+            ProcessFifoBlock(ppfFifoDst);
+            m_nFifoPosition = 0;
+        }
+    }
+}
+
+void CAmbisonicBinauralizer::ProcessFifoBlock(float** ppfDst)
+{
+    Process(&m_BFInputFifo, ppfDst);
+}
+
+void CAmbisonicBinauralizer::SetLowCPU(bool bLowCPU)
+{
+    m_bLowCPU = bLowCPU;
+}
+
+bool CAmbisonicBinauralizer::GetLowCPU()
+{
+    return m_bLowCPU;
+}
+
+void CAmbisonicBinauralizer::SetFilterCacheDirectory(std::string sDirectory)
+{
+    m_FilterCache.SetDirectory(sDirectory);
+}
+
+std::string CAmbisonicBinauralizer::GetFilterCacheDirectory()
+{
+    return m_FilterCache.GetDirectory();
+}
+
+void CAmbisonicBinauralizer::ProcessConvolution(float** ppfSrc, float** ppfDst, bool bLowCPU)
+{
+    unsigned niEar = 0;
+    unsigned niChannel = 0;
+    unsigned ni = 0;
+
+    if(m_nPartitions > 1)
+    {
+        ProcessPartitioned(ppfSrc, ppfDst, bLowCPU);
+        return;
+    }
+
+    kiss_fft_cpx* pcpAccumulator[2] = {m_pcpAccumulator[0].get(), m_pcpAccumulator[1].get()};
+    for(niEar = 0; niEar < 2; niEar++)
+        memset(pcpAccumulator[niEar], 0, m_nFFTBins * sizeof(kiss_fft_cpx));
+
+    // Each channel is transformed once and its spectrum is used for both ears. The convolved channels are
+    // summed in the frequency domain so only one inverse FFT is needed per ear.
+    for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    {
+        memcpy(m_pfScratchBufferB.data(), ppfSrc[niChannel], m_nBlockSize * sizeof(float));
+        memset(&m_pfScratchBufferB[m_nBlockSize], 0, (m_nFFTSize - m_nBlockSize) * sizeof(float));
+        m_pFFT->forward(m_pfScratchBufferB.data(), m_pcpScratch.get());
+
+        if(bLowCPU)
         {
-            memcpy(m_pfScratchBufferB.data(), pBFSrc->m_ppfChannels[niChannel], m_nBlockSize * sizeof(float));
-            memset(&m_pfScratchBufferB[m_nBlockSize], 0, (m_nFFTSize - m_nBlockSize) * sizeof(float));
-            kiss_fftr(m_pFFT_cfg.get(), m_pfScratchBufferB.data(), m_pcpScratch.get());
+            // Perform the convolutions for the left ear and generate the right ear from a modified accumulation of these channels
+            // Subtract certain channels (such as Y) to generate right ear.
+            float fSign = m_pfSymmetrySign[niChannel];
+            spectrumMultiply(m_pcpScratch.get(), m_pFilters->GetFilter(0, niChannel), m_pcpScratch.get(), m_nFFTBins);
             for(ni = 0; ni < m_nFFTBins; ni++)
             {
-                cpTemp.r = m_pcpScratch[ni].r * m_ppcpFilters[niEar][niChannel][ni].r
-                            - m_pcpScratch[ni].i * m_ppcpFilters[niEar][niChannel][ni].i;
-                cpTemp.i = m_pcpScratch[ni].r * m_ppcpFilters[niEar][niChannel][ni].i
-                            + m_pcpScratch[ni].i * m_ppcpFilters[niEar][niChannel][ni].r;
-                m_pcpScratch[ni] = cpTemp;
-            }
-            kiss_fftri(m_pIFFT_cfg.get(), m_pcpScratch.get(), m_pfScratchBufferB.data());
-            for(ni = 0; ni < m_nFFTSize; ni++)
-                m_pfScratchBufferA[ni] += m_pfScratchBufferB[ni];
-
-            for(ni = 0; ni < m_nFFTSize; ni++){
-                // Subtract certain channels (such as Y) to generate right ear.
-                if((niChannel==1) || (niChannel==4) || (niChannel==5) ||
-                    (niChannel==9) || (niChannel==10)|| (niChannel==11))
-                {
-                    m_pfScratchBufferC[ni] -= m_pfScratchBufferB[ni];
-                }
-                else{
-                    m_pfScratchBufferC[ni] += m_pfScratchBufferB[ni];
-                }
+                pcpAccumulator[0][ni].r += m_pcpScratch[ni].r;
+                pcpAccumulator[0][ni].i += m_pcpScratch[ni].i;
+                pcpAccumulator[1][ni].r += fSign * m_pcpScratch[ni].r;
+                pcpAccumulator[1][ni].i += fSign * m_pcpScratch[ni].i;
             }
         }
-        for(ni = 0; ni < m_nFFTSize; ni++){
-            m_pfScratchBufferA[ni] *= m_fFFTScaler;
-            m_pfScratchBufferC[ni] *= m_fFFTScaler;
-        }
-        memcpy(ppfDst[0], m_pfScratchBufferA.data(), m_nBlockSize * sizeof(float));
-        memcpy(ppfDst[1], m_pfScratchBufferC.data(), m_nBlockSize * sizeof(float));
-        for(ni = 0; ni < m_nOverlapLength; ni++){
-            ppfDst[0][ni] += m_pfOverlap[0][ni];
-            ppfDst[1][ni] += m_pfOverlap[1][ni];
+        else
+        {
+            // Perform the convolution on both ears. Potentially more realistic results but requires double the number of
+            // convolutions.
+            for(niEar = 0; niEar < 2; niEar++)
+                spectrumMultiplyAccumulate(m_pcpScratch.get(), m_pFilters->GetFilter(niEar, niChannel), pcpAccumulator[niEar], m_nFFTBins);
         }
-        memcpy(m_pfOverlap[0].data(), &m_pfScratchBufferA[m_nBlockSize], m_nOverlapLength * sizeof(float));
-        memcpy(m_pfOverlap[1].data(), &m_pfScratchBufferC[m_nBlockSize], m_nOverlapLength * sizeof(float));
     }
-    else
+
+    for(niEar = 0; niEar < 2; niEar++)
+    {
+        m_pFFT->inverse(pcpAccumulator[niEar], m_pfScratchBufferA.data());
+        for(ni = 0; ni < m_nFFTSize; ni++)
+            m_pfScratchBufferA[ni] *= m_fFFTScaler;
+        memcpy(ppfDst[niEar], m_pfScratchBufferA.data(), m_nBlockSize * sizeof(float));
+        for(ni = 0; ni < m_nOverlapLength; ni++)
+            ppfDst[niEar][ni] += m_pfOverlap[niEar][ni];
+        memcpy(m_pfOverlap[niEar].data(), &m_pfScratchBufferA[m_nBlockSize], m_nOverlapLength * sizeof(float));
+    }
+}
+
+void CAmbisonicBinauralizer::ProcessPartitioned(float** ppfSrc, float** ppfDst, bool bLowCPU)
+{
+    unsigned niEar = 0;
+    unsigned niChannel = 0;
+    unsigned niPartition = 0;
+    unsigned ni = 0;
+    unsigned nHistory = m_nFFTSize - m_nBlockSize;
+    kiss_fft_cpx* pcpAccumulator[2] = {m_pcpAccumulator[0].get(), m_pcpAccumulator[1].get()};
+
+    /* Uniformly partitioned overlap-save convolution. Each filter is split into m_nPartitions partitions
+    of m_nBlockSize taps. The spectra of the last m_nPartitions input blocks of every channel are kept in
+    a frequency-domain delay line (FDL) so the input only needs to be transformed once per block. The output
+    of each ear is the sum over all channels and partitions of the product of the delayed input spectrum
+    and the matching filter partition, followed by a single inverse FFT.
+    The newest spectrum is written at m_nFDLPosition, the spectrum delayed by p blocks is found at
+    (m_nFDLPosition + p) % m_nPartitions. */
+    m_nFDLPosition = (m_nFDLPosition + m_nPartitions - 1) % m_nPartitions;
+
+    for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    {
+        // Slide the input window along by one block and transform it into the delay line
+        float* pfInput = m_ppfInputHistory[niChannel].data();
+        memmove(pfInput, &pfInput[m_nBlockSize], nHistory * sizeof(float));
+        memcpy(&pfInput[nHistory], ppfSrc[niChannel], m_nBlockSize * sizeof(float));
+        m_pFFT->forward(pfInput, &m_ppcpFDL[niChannel][m_nFDLPosition * m_nFFTBins]);
+    }
+
+    for(niEar = 0; niEar < 2; niEar++)
+        memset(pcpAccumulator[niEar], 0, m_nFFTBins * sizeof(kiss_fft_cpx));
+
+    for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
     {
-        // Perform the convolution on both ears. Potentially more realistic results but requires double the number of
-        // convolutions.
-        for(niEar = 0; niEar < 2; niEar++)
+        // With bLowCPU only the left ear filters are convolved and the result is added to or subtracted from
+        // the right ear depending on the left-right symmetry of the channel.
+        unsigned nEars = bLowCPU ? 1 : 2;
+        for(niEar = 0; niEar < nEars; niEar++)
         {
-            memset(m_pfScratchBufferA.data(), 0, m_nFFTSize * sizeof(float));
-            for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+            kiss_fft_cpx* pcpDst = bLowCPU ? m_pcpScratch.get() : pcpAccumulator[niEar];
+            if(bLowCPU)
+                memset(pcpDst, 0, m_nFFTBins * sizeof(kiss_fft_cpx));
+
+            for(niPartition = 0; niPartition < m_nPartitions; niPartition++)
             {
-                memcpy(m_pfScratchBufferB.data(), pBFSrc->m_ppfChannels[niChannel], m_nBlockSize * sizeof(float));
-                memset(&m_pfScratchBufferB[m_nBlockSize], 0, (m_nFFTSize - m_nBlockSize) * sizeof(float));
-                kiss_fftr(m_pFFT_cfg.get(), m_pfScratchBufferB.data(), m_pcpScratch.get());
-                for(ni = 0; ni < m_nFFTBins; ni++)
-                {
-                    cpTemp.r = m_pcpScratch[ni].r * m_ppcpFilters[niEar][niChannel][ni].r
-                                - m_pcpScratch[ni].i * m_ppcpFilters[niEar][niChannel][ni].i;
-                    cpTemp.i = m_pcpScratch[ni].r * m_ppcpFilters[niEar][niChannel][ni].i
-                                + m_pcpScratch[ni].i * m_ppcpFilters[niEar][niChannel][ni].r;
-                    m_pcpScratch[ni] = cpTemp;
-                }
-                kiss_fftri(m_pIFFT_cfg.get(), m_pcpScratch.get(), m_pfScratchBufferB.data());
-                for(ni = 0; ni < m_nFFTSize; ni++)
-                    m_pfScratchBufferA[ni] += m_pfScratchBufferB[ni];
+                unsigned nSlot = (m_nFDLPosition + niPartition) % m_nPartitions;
+                const kiss_fft_cpx* pcpIn = &m_ppcpFDL[niChannel][nSlot * m_nFFTBins];
+                const kiss_fft_cpx* pcpFilter = &m_pFilters->GetFilter(niEar, niChannel)[niPartition * m_nFFTBins];
+                spectrumMultiplyAccumulate(pcpIn, pcpFilter, pcpDst, m_nFFTBins);
+            }
+        }
+        if(bLowCPU)
+        {
+            // Subtract certain channels (such as Y) to generate right ear.
+            float fSign = m_pfSymmetrySign[niChannel];
+            for(ni = 0; ni < m_nFFTBins; ni++)
+            {
+                pcpAccumulator[0][ni].r += m_pcpScratch[ni].r;
+                pcpAccumulator[0][ni].i += m_pcpScratch[ni].i;
+                pcpAccumulator[1][ni].r += fSign * m_pcpScratch[ni].r;
+                pcpAccumulator[1][ni].i += fSign * m_pcpScratch[ni].i;
             }
-            for(ni = 0; ni < m_nFFTSize; ni++)
-                m_pfScratchBufferA[ni] *= m_fFFTScaler;
-            memcpy(ppfDst[niEar], m_pfScratchBufferA.data(), m_nBlockSize * sizeof(float));
-            for(ni = 0; ni < m_nOverlapLength; ni++)
-                ppfDst[niEar][ni] += m_pfOverlap[niEar][ni];
-            memcpy(m_pfOverlap[niEar].data(), &m_pfScratchBufferA[m_nBlockSize], m_nOverlapLength * sizeof(float));
         }
     }
+
+    // Only the last m_nBlockSize samples of the circular convolution are valid
+    for(niEar = 0; niEar < 2; niEar++)
+    {
+        m_pFFT->inverse(pcpAccumulator[niEar], m_pfScratchBufferA.data());
+        for(ni = 0; ni < m_nBlockSize; ni++)
+            ppfDst[niEar][ni] = m_pfScratchBufferA[nHistory + ni] * m_fFFTScaler;
+    }
 }
 
 void CAmbisonicBinauralizer::ArrangeSpeakers()
@@ -309,15 +670,9 @@ void CAmbisonicBinauralizer::ArrangeSpeakers()
     //Custom speaker setup
     // Select cube layout for first order a dodecahedron for 2nd and 3rd
     if (m_nOrder == 1)
-    {
-        std::cout << "Getting first order cube" << std::endl;
         nSpeakerSetUp = kAmblib_Cube2;
-    }
     else
-    {
-        std::cout << "Getting second/third order dodecahedron" << std::endl;
         nSpeakerSetUp = kAmblib_Dodecahedron;
-    }
 
     m_AmbDecoder.Configure(m_nOrder, m_b3D, nSpeakerSetUp, nSpeakers);
 
@@ -357,29 +712,157 @@ HRTF *CAmbisonicBinauralizer::getHRTF(unsigned nSampleRate, std::string HRTFPath
     return p_hrtf;
 }
 
+std::string CAmbisonicBinauralizer::GetHRTFKey(unsigned nSampleRate, std::string HRTFPath)
+{
+    std::string sHRTF;
+#ifdef HAVE_MIT_HRTF
+    if (HRTFPath == "")
+        sHRTF = "mit";
+#endif
+    if (sHRTF.empty())
+    {
+        //A changed SOFA file gets a new key
+        struct stat fileStat;
+        if (stat(HRTFPath.c_str(), &fileStat) != 0)
+            return "";
+        sHRTF = "sofa " + HRTFPath + " " + std::to_string((long long)fileStat.st_size)
+                + " " + std::to_string((long long)fileStat.st_mtime);
+    }
+
+    return "hrtf=" + sHRTF + " rate=" + std::to_string(nSampleRate);
+}
+
+bool CAmbisonicBinauralizer::FindFilters(const std::string& sKey, unsigned& tailLength)
+{
+    if(sKey.empty())
+        return false;
+
+    //The registry is checked first, the cache is only read when no binauralizer holds the filters
+    std::shared_ptr<const CBinauralFilterSet> pFilters = CBinauralFilterRegistry::GetInstance().Find(sKey);
+    if(!pFilters && m_FilterCache.IsEnabled() && m_FilterCache.Open(sKey))
+    {
+        std::shared_ptr<CBinauralFilterSet> pLoaded = std::make_shared<CBinauralFilterSet>(m_FilterCache.GetTaps(),
+            m_FilterCache.GetFFTSize(), m_FilterCache.GetPartitions(), m_FilterCache.GetChannelCount());
+        for(unsigned niEar = 0; niEar < 2; niEar++)
+            for(unsigned niChannel = 0; niChannel < pLoaded->GetChannelCount(); niChannel++)
+                memcpy(pLoaded->GetFilter(niEar, niChannel), m_FilterCache.GetFilter(niEar, niChannel),
+                       pLoaded->GetFilterSize() * sizeof(kiss_fft_cpx));
+        m_FilterCache.Close();
+        pFilters = CBinauralFilterRegistry::GetInstance().Insert(sKey, pLoaded);
+    }
+    if(!pFilters)
+        return false;
+
+    m_nTaps = pFilters->GetTaps();
+    ConfigureFFTSize();
+    if(pFilters->GetFFTSize() != m_nFFTSize || pFilters->GetPartitions() != m_nPartitions
+        || pFilters->GetChannelCount() != m_nChannelCount)
+        return false;
+
+    AllocateBuffers();
+    if(!m_pFFT)
+        return false;
+
+    m_pFilters = pFilters;
+    tailLength = m_nTaps;
+    return true;
+}
+
+void CAmbisonicBinauralizer::ShareFilters(const std::string& sKey, std::shared_ptr<CBinauralFilterSet> pFilters)
+{
+    if(sKey.empty())
+    {
+        m_pFilters = pFilters;
+        return;
+    }
+
+    m_FilterCache.Store(sKey, *pFilters);
+    m_pFilters = CBinauralFilterRegistry::GetInstance().Insert(sKey, pFilters);
+}
 
 void CAmbisonicBinauralizer::AllocateBuffers()
 {
     //Allocate scratch buffers
     m_pfScratchBufferA.resize(m_nFFTSize);
     m_pfScratchBufferB.resize(m_nFFTSize);
-    m_pfScratchBufferC.resize(m_nFFTSize);
 
     //Allocate overlap-add buffers
     m_pfOverlap[0].resize(m_nOverlapLength);
     m_pfOverlap[1].resize(m_nOverlapLength);
 
     //Allocate FFT and iFFT for new size
-    m_pFFT_cfg.reset(kiss_fftr_alloc(m_nFFTSize, 0, 0, 0));
-    m_pIFFT_cfg.reset(kiss_fftr_alloc(m_nFFTSize, 1, 0, 0));
+    m_pFFT.reset(createFFT(m_nFFTSize));
 
-    //Allocate the FFTBins for each channel, for each ear
-    for(unsigned niEar = 0; niEar < 2; niEar++)
+    m_pcpScratch.reset(new kiss_fft_cpx[m_nFFTBins]);
+    m_pcpAccumulator[0].reset(new kiss_fft_cpx[m_nFFTBins]);
+    m_pcpAccumulator[1].reset(new kiss_fft_cpx[m_nFFTBins]);
+
+    //Allocate the input history and frequency-domain delay line of the partitioned convolution
+    unsigned nDelayLines = m_nPartitions > 1 ? m_nChannelCount : 0;
+    m_ppfInputHistory.resize(nDelayLines);
+    m_ppcpFDL.resize(nDelayLines);
+    for(unsigned niChannel = 0; niChannel < nDelayLines; niChannel++)
     {
-        m_ppcpFilters[niEar].resize(m_nChannelCount);
-        for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
-            m_ppcpFilters[niEar][niChannel].reset(new kiss_fft_cpx[m_nFFTBins]);
+        m_ppfInputHistory[niChannel].assign(m_nFFTSize, 0.f);
+        m_ppcpFDL[niChannel].reset(new kiss_fft_cpx[m_nPartitions * m_nFFTBins]());
     }
+    m_nFDLPosition = 0;
 
-    m_pcpScratch.reset(new kiss_fft_cpx[m_nFFTBins]);
+    //Allocate the FIFOs of the Process() taking any number of samples
+    m_ppfInputFifo.resize(m_nChannelCount);
+    m_ppfInputFifoChannels.resize(m_nChannelCount);
+    for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    {
+        m_ppfInputFifo[niChannel].assign(m_nBlockSize, 0.f);
+        m_ppfInputFifoChannels[niChannel] = m_ppfInputFifo[niChannel].data();
+    }
+    m_pfOutputFifo[0].assign(m_nBlockSize, 0.f);
+    m_pfOutputFifo[1].assign(m_nBlockSize, 0.f);
+    m_nFifoPosition = 0;
+    if(OrderToComponents(m_nOrder, m_b3D) == m_nChannelCount)
+    {
+        m_BFInputFifo.Configure(m_nOrder, m_b3D, m_nBlockSize);
+        m_BFInputFifo.SetChannels(m_ppfInputFifoChannels.data());
+    }
+}
+
+void CAmbisonicBinauralizer::ConfigureFFTSize()
+{
+    m_nFFTSize = 1;
+    if(m_nTaps > m_nBlockSize)
+    {
+        //Split the filters into partitions of one block each. Overlap-save is used so no
+        //overlap-add buffer is needed, only the previous input of each channel.
+        m_nPartitions = (m_nTaps + m_nBlockSize - 1) / m_nBlockSize;
+        m_nOverlapLength = 0;
+        //How large does the FFT need to be
+        while(m_nFFTSize < 2 * m_nBlockSize)
+            m_nFFTSize <<= 1;
+    }
+    else
+    {
+        m_nPartitions = 1;
+        //What will the overlap size be?
+        m_nOverlapLength = m_nTaps - 1;
+        //How large does the FFT need to be
+        while(m_nFFTSize < (m_nBlockSize + m_nTaps + m_nOverlapLength))
+            m_nFFTSize <<= 1;
+    }
+    //How many bins is that
+    m_nFFTBins = m_nFFTSize / 2 + 1;
+    //What do we need to scale the result of the iFFT by
+    m_fFFTScaler = 1.f / m_nFFTSize;
+}
+
+void CAmbisonicBinauralizer::ConvertFilter(const float* pfTaps, kiss_fft_cpx* pcpFilter)
+{
+    unsigned nPartitionLength = m_nPartitions > 1 ? m_nBlockSize : m_nTaps;
+    for(unsigned niPartition = 0; niPartition < m_nPartitions; niPartition++)
+    {
+        unsigned nOffset = niPartition * nPartitionLength;
+        unsigned nLength = std::min(nPartitionLength, m_nTaps - nOffset);
+        memcpy(m_pfScratchBufferA.data(), &pfTaps[nOffset], nLength * sizeof(float));
+        memset(&m_pfScratchBufferA[nLength], 0, (m_nFFTSize - nLength) * sizeof(float));
+        m_pFFT->forward(m_pfScratchBufferA.data(), &pcpFilter[niPartition * m_nFFTBins]);
+    }
 }
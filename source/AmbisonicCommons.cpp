@@ -34,32 +34,10 @@ unsigned OrderToComponents(unsigned nOrder, bool b3D)
 
 unsigned OrderToComponentPosition(unsigned nOrder, bool b3D)
 {
-
-
-    unsigned nIndex = 0;
-
     if(b3D)
-    {
-        switch(nOrder)
-        {
-        case 0:    nIndex = 0;    break;
-        case 1:    nIndex = 1;    break;
-        case 2:    nIndex = 4;    break;
-        case 3:    nIndex = 10;break;
-        }
-    }
+        return nOrder * nOrder;
     else
-    {
-        switch(nOrder)
-        {
-        case 0:    nIndex = 0;    break;
-        case 1:    nIndex = 1;    break;
-        case 2:    nIndex = 3;    break;
-        case 3:    nIndex = 5;    break;
-        }
-    }
-
-    return nIndex;
+        return nOrder > 0 ? nOrder * 2 - 1 : 0;
 }
 
 unsigned OrderToSpeakers(unsigned nOrder, bool b3D)
@@ -113,3 +91,159 @@ char ComponentToChannelLabel(unsigned nComponent, bool b3D)
 
     return cLabel;
 }
+
+void SphericalHarmonicNormalisation(unsigned nOrder, bool b3D, AmbisonicNormalisation eNorm, float* pfNorm)
+{
+    // SN3D to FuMa (MaxN) conversion factors in ACN order
+    static const float pfFuMa3D[] = {
+        1.f / sqrtf(2.f),
+        1.f, 1.f, 1.f,
+        2.f / sqrtf(3.f), 2.f / sqrtf(3.f), 1.f, 2.f / sqrtf(3.f), 2.f / sqrtf(3.f),
+        sqrtf(8.f / 5.f), 3.f / sqrtf(5.f), sqrtf(45.f / 32.f), 1.f, sqrtf(45.f / 32.f), 3.f / sqrtf(5.f), sqrtf(8.f / 5.f)
+    };
+
+    if(b3D)
+    {
+        for(unsigned l = 0; l <= nOrder; l++)
+        {
+            for(unsigned m = 0; m <= l; m++)
+            {
+                // SN3D: sqrt((2 - delta_m0) * (l - m)! / (l + m)!)
+                double dFactorialRatio = 1.;
+                for(unsigned k = l - m + 1; k <= l + m; k++)
+                    dFactorialRatio /= k;
+                float fNorm = (float)sqrt((m == 0 ? 1. : 2.) * dFactorialRatio);
+                if(eNorm == kN3D)
+                    fNorm *= sqrtf(2.f * l + 1.f);
+
+                unsigned nCos = l * l + l + m;
+                unsigned nSin = l * l + l - m;
+                pfNorm[nCos] = fNorm;
+                pfNorm[nSin] = fNorm;
+                if(eNorm == kFuMa && l <= 3)
+                {
+                    pfNorm[nCos] = fNorm * pfFuMa3D[nCos];
+                    pfNorm[nSin] = fNorm * pfFuMa3D[nSin];
+                }
+            }
+        }
+    }
+    else
+    {
+        pfNorm[0] = eNorm == kFuMa ? 1.f / sqrtf(2.f) : 1.f;
+        for(unsigned m = 1; m <= nOrder; m++)
+        {
+            float fNorm = eNorm == kN3D ? sqrtf(2.f) : 1.f;
+            pfNorm[2 * m - 1] = fNorm;
+            pfNorm[2 * m] = fNorm;
+        }
+    }
+}
+
+void SphericalHarmonics(unsigned nOrder, bool b3D, float fAzimuth, float fElevation, const float* pfNorm, float* pfCoeff)
+{
+    const double dCosAzim = cos(fAzimuth);
+    const double dSinAzim = sin(fAzimuth);
+    const double dCosElev = cos(fElevation);
+    const double dSinElev = sin(fElevation);
+
+    // cos(m * azimuth) and sin(m * azimuth) by Chebyshev recursion, starting at m = 0
+    double dCosM = 1., dSinM = 0.;
+    double dCosMPrev = dCosAzim, dSinMPrev = -dSinAzim;
+    // cos(elevation)^m for 2D, and (2m - 1)!! * cos(elevation)^m = P_m^m(sin(elevation)) for 3D
+    double dCosElevM = 1.;
+    double dPmm = 1.;
+
+    for(unsigned m = 0; m <= nOrder; m++)
+    {
+        if(m > 0)
+        {
+            double dCosNext = 2. * dCosAzim * dCosM - dCosMPrev;
+            double dSinNext = 2. * dCosAzim * dSinM - dSinMPrev;
+            dCosMPrev = dCosM;
+            dSinMPrev = dSinM;
+            dCosM = dCosNext;
+            dSinM = dSinNext;
+            dCosElevM *= dCosElev;
+            dPmm *= (2. * m - 1.) * dCosElev;
+        }
+
+        if(!b3D)
+        {
+            if(m == 0)
+                pfCoeff[0] = pfNorm[0];
+            else
+            {
+                pfCoeff[2 * m - 1] = (float)(dCosM * dCosElevM) * pfNorm[2 * m - 1];
+                pfCoeff[2 * m] = (float)(dSinM * dCosElevM) * pfNorm[2 * m];
+            }
+            continue;
+        }
+
+        // Associated Legendre functions (without the Condon-Shortley phase) of sin(elevation) for l >= m:
+        // P_(m+1)^m = (2m + 1) x P_m^m
+        // P_l^m = ((2l - 1) x P_(l-1)^m - (l + m - 1) P_(l-2)^m) / (l - m)
+        double dPlm2 = 0., dPlm1 = 0., dPlm = dPmm;
+        for(unsigned l = m; l <= nOrder; l++)
+        {
+            if(l == m + 1)
+                dPlm = (2. * m + 1.) * dSinElev * dPlm1;
+            else if(l > m + 1)
+                dPlm = ((2. * l - 1.) * dSinElev * dPlm1 - (l + m - 1.) * dPlm2) / (l - m);
+
+            unsigned nCos = l * l + l + m;
+            unsigned nSin = l * l + l - m;
+            pfCoeff[nCos] = (float)(dPlm * dCosM) * pfNorm[nCos];
+            if(m > 0)
+                pfCoeff[nSin] = (float)(dPlm * dSinM) * pfNorm[nSin];
+
+            dPlm2 = dPlm1;
+            dPlm1 = dPlm;
+        }
+    }
+}
+
+void MatrixMix(const float* pfMatrix, unsigned nOutputs, unsigned nInputs,
+               const float* const* ppfIn, float* const* ppfOut, unsigned nSamples)
+{
+    // The samples are processed in chunks small enough for the input data of
+    // a chunk to stay in L1 cache while every output is accumulated, so each
+    // input is read from memory once. Four inputs are summed per pass over an
+    // output chunk so the accumulator is loaded and stored once for every four.
+    const unsigned knChunk = 64;
+
+    for(unsigned niStart = 0; niStart < nSamples; niStart += knChunk)
+    {
+        unsigned nChunk = nSamples - niStart < knChunk ? nSamples - niStart : knChunk;
+
+        for(unsigned niOutput = 0; niOutput < nOutputs; niOutput++)
+        {
+            float* __restrict pfOut = &ppfOut[niOutput][niStart];
+            const float* pfGains = &pfMatrix[niOutput * nInputs];
+            memset(pfOut, 0, nChunk * sizeof(float));
+
+            unsigned niInput = 0;
+            for(; niInput + 4 <= nInputs; niInput += 4)
+            {
+                const float* __restrict pfIn0 = &ppfIn[niInput][niStart];
+                const float* __restrict pfIn1 = &ppfIn[niInput + 1][niStart];
+                const float* __restrict pfIn2 = &ppfIn[niInput + 2][niStart];
+                const float* __restrict pfIn3 = &ppfIn[niInput + 3][niStart];
+                const float fGain0 = pfGains[niInput];
+                const float fGain1 = pfGains[niInput + 1];
+                const float fGain2 = pfGains[niInput + 2];
+                const float fGain3 = pfGains[niInput + 3];
+                for(unsigned niSample = 0; niSample < nChunk; niSample++)
+                    pfOut[niSample] += fGain0 * pfIn0[niSample] + fGain1 * pfIn1[niSample]
+                                     + fGain2 * pfIn2[niSample] + fGain3 * pfIn3[niSample];
+            }
+            for(; niInput < nInputs; niInput++)
+            {
+                const float* __restrict pfIn = &ppfIn[niInput][niStart];
+                const float fGain = pfGains[niInput];
+                for(unsigned niSample = 0; niSample < nChunk; niSample++)
+                    pfOut[niSample] += fGain * pfIn[niSample];
+            }
+        }
+    }
+}
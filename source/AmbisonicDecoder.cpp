@@ -15,13 +15,20 @@
 
 
 #include "AmbisonicDecoder.h"
-#include <iostream>
+#include <algorithm>
+
+static const unsigned knDualBandChunk = 64;
 
 CAmbisonicDecoder::CAmbisonicDecoder()
 {
     m_nSpeakerSetUp = 0;
     m_nSpeakers = 0;
     m_pAmbSpeakers = nullptr;
+    m_bDecoderMatrixDirty = true;
+    m_bDualBand = false;
+    m_nSampleRate = DEFAULT_SAMPLERATE;
+    m_fCrossoverRequested = 0.f;
+    m_fCrossoverFrequency = 0.f;
 }
 
 CAmbisonicDecoder::~CAmbisonicDecoder()
@@ -36,6 +43,8 @@ bool CAmbisonicDecoder::Configure(unsigned nOrder, bool b3D, int nSpeakerSetUp,
     if(!success)
         return false;
     SpeakerSetUp(nSpeakerSetUp, nSpeakers);
+    m_pfDecoderMatrix.resize(m_nSpeakers * m_nChannelCount);
+    ConfigureDualBand();
     Refresh();
     
     return true;
@@ -45,20 +54,193 @@ void CAmbisonicDecoder::Reset()
 {
     for(unsigned niSpeaker = 0; niSpeaker < m_nSpeakers; niSpeaker++)
         m_pAmbSpeakers[niSpeaker].Reset();
+    for(auto& filter : m_LowPass)
+        filter.Reset();
+    for(auto& filter : m_HighPass)
+        filter.Reset();
 }
 
 void CAmbisonicDecoder::Refresh()
 {
     for(unsigned niSpeaker = 0; niSpeaker < m_nSpeakers; niSpeaker++)
         m_pAmbSpeakers[niSpeaker].Refresh();
+    UpdateDecoderMatrix();
 }
 
 void CAmbisonicDecoder::Process(CBFormat* pBFSrc, unsigned nSamples, float** ppfDst)
 {
-    for(unsigned niSpeaker = 0; niSpeaker < m_nSpeakers; niSpeaker++)
+    // Coefficients set directly on the speakers since the last Refresh()
+    if(m_bDecoderMatrixDirty)
+        UpdateDecoderMatrix();
+
+    if(m_bDualBand)
+    {
+        ProcessDualBand(pBFSrc, nSamples, ppfDst);
+        return;
+    }
+
+    MatrixMix(m_pfDecoderMatrix.data(), m_nSpeakers, m_nChannelCount,
+              pBFSrc->m_ppfChannels.get(), ppfDst, nSamples);
+}
+
+void CAmbisonicDecoder::ProcessDualBand(CBFormat* pBFSrc, unsigned nSamples, float** ppfDst)
+{
+    // The basic and max-rE decoders only differ by a gain per order, so each
+    // channel is recombined as low + gain * high and decoded with one matrix
+    float* pfHigh = m_pfHighScratch.data();
+
+    for(unsigned niStart = 0; niStart < nSamples; niStart += knDualBandChunk)
+    {
+        unsigned nChunk = nSamples - niStart < knDualBandChunk ? nSamples - niStart : knDualBandChunk;
+
+        for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+        {
+            const float* pfIn = &pBFSrc->m_ppfChannels[niChannel][niStart];
+            float* __restrict pfLow = &m_pfBandScratch[niChannel * knDualBandChunk];
+
+            m_LowPass[2 * niChannel].Process(pfIn, pfLow, nChunk);
+            m_LowPass[2 * niChannel + 1].Process(pfLow, pfLow, nChunk);
+            m_HighPass[2 * niChannel].Process(pfIn, pfHigh, nChunk);
+            m_HighPass[2 * niChannel + 1].Process(pfHigh, pfHigh, nChunk);
+
+            // The 4th order Linkwitz-Riley bands sum to an all-pass, so they are recombined in phase
+            const float fGain = m_pfHighGain[niChannel];
+            for(unsigned niSample = 0; niSample < nChunk; niSample++)
+                pfLow[niSample] += fGain * pfHigh[niSample];
+        }
+
+        for(unsigned niSpeaker = 0; niSpeaker < m_nSpeakers; niSpeaker++)
+            m_ppfChunkOut[niSpeaker] = &ppfDst[niSpeaker][niStart];
+
+        MatrixMix(m_pfDecoderMatrix.data(), m_nSpeakers, m_nChannelCount,
+                  m_ppfChunkIn.data(), m_ppfChunkOut.data(), nChunk);
+    }
+}
+
+void CAmbisonicDecoder::SetDualBand(bool bDualBand, unsigned nSampleRate, float fCrossoverFrequency)
+{
+    // The crossovers start from silence when dual-band decoding is switched on
+    if(bDualBand && !m_bDualBand)
+    {
+        for(auto& filter : m_LowPass)
+            filter.Reset();
+        for(auto& filter : m_HighPass)
+            filter.Reset();
+    }
+    m_bDualBand = bDualBand;
+    m_nSampleRate = nSampleRate;
+    m_fCrossoverRequested = fCrossoverFrequency;
+    UpdateCrossover();
+}
+
+bool CAmbisonicDecoder::GetDualBand()
+{
+    return m_bDualBand;
+}
+
+float CAmbisonicDecoder::GetCrossoverFrequency()
+{
+    return m_fCrossoverFrequency;
+}
+
+void CAmbisonicDecoder::ConfigureDualBand()
+{
+    // max-rE weights per order
+    std::vector<float> pfOrderGain(m_nOrder + 1);
+    if(m_b3D)
+    {
+        // Legendre polynomials at cos(137.9 deg / (N + 1.51))
+        float fCos = cosf(DegreesToRadians(137.9f) / (m_nOrder + 1.51f));
+        float fP0 = 1.f, fP1 = fCos;
+        pfOrderGain[0] = 1.f;
+        for(unsigned l = 1; l <= m_nOrder; l++)
+        {
+            pfOrderGain[l] = fP1;
+            float fP2 = ((2.f * l + 1.f) * fCos * fP1 - l * fP0) / (l + 1.f);
+            fP0 = fP1;
+            fP1 = fP2;
+        }
+    }
+    else
     {
-        m_pAmbSpeakers[niSpeaker].Process(pBFSrc, nSamples, ppfDst[niSpeaker]);
+        for(unsigned l = 0; l <= m_nOrder; l++)
+            pfOrderGain[l] = cosf(l * (float)M_PI / (2.f * m_nOrder + 2.f));
+    }
+
+    // Normalise so the high band keeps the energy of the basic decoder. Each order is weighted by the
+    // energy it brings to a diffuse field decoded on a regular layout, with the scaling of the decoder
+    // (see CAmbisonicSpeaker::Process()): 2l + 1 in 3D. In 2D every channel, W included, is doubled and
+    // each of the two circular harmonics of an order has half the power of W, so the weights are 1, 1/2, 1/2...
+    float fEnergyBasic = 0.f, fEnergyRE = 0.f;
+    for(unsigned l = 0; l <= m_nOrder; l++)
+    {
+        float fOrderEnergy = m_b3D ? 2.f * l + 1.f : (l == 0 ? 1.f : 0.5f);
+        fEnergyBasic += fOrderEnergy;
+        fEnergyRE += fOrderEnergy * pfOrderGain[l] * pfOrderGain[l];
+    }
+    float fNorm = sqrtf(fEnergyBasic / fEnergyRE);
+
+    m_pfHighGain.resize(m_nChannelCount);
+    for(unsigned l = 0; l <= m_nOrder; l++)
+    {
+        unsigned niStart = OrderToComponentPosition(l, m_b3D);
+        unsigned niEnd = OrderToComponentPosition(l + 1, m_b3D);
+        for(unsigned niChannel = niStart; niChannel < niEnd && niChannel < m_nChannelCount; niChannel++)
+            m_pfHighGain[niChannel] = pfOrderGain[l] * fNorm;
+    }
+
+    m_LowPass.assign(2 * m_nChannelCount, CBiquad());
+    m_HighPass.assign(2 * m_nChannelCount, CBiquad());
+    UpdateCrossover();
+
+    m_pfBandScratch.assign(m_nChannelCount * knDualBandChunk, 0.f);
+    m_pfHighScratch.assign(knDualBandChunk, 0.f);
+    m_ppfChunkIn.resize(m_nChannelCount);
+    for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+        m_ppfChunkIn[niChannel] = &m_pfBandScratch[niChannel * knDualBandChunk];
+    m_ppfChunkOut.resize(m_nSpeakers);
+}
+
+void CAmbisonicDecoder::UpdateCrossover()
+{
+    unsigned nOrder = m_nOrder > 0 ? m_nOrder : 1;
+
+    m_fCrossoverFrequency = m_fCrossoverRequested;
+    if(m_fCrossoverFrequency <= 0.f)
+    {
+        // Frequency above which the basic decoder no longer reconstructs the
+        // velocity vector over a head sized region (radius 9 cm)
+        const float fSpeedOfSound = 343.f;
+        const float fRadius = 0.09f;
+        m_fCrossoverFrequency = fSpeedOfSound * nOrder
+            / (4.f * fRadius * (nOrder + 1) * sinf((float)M_PI / (2.f * nOrder + 2.f)));
+    }
+    // Keep the crossover below Nyquist
+    m_fCrossoverFrequency = std::min(m_fCrossoverFrequency, 0.45f * m_nSampleRate);
+
+    for(auto& filter : m_LowPass)
+        filter.SetLowPass(m_fCrossoverFrequency, (float)m_nSampleRate);
+    for(auto& filter : m_HighPass)
+        filter.SetHighPass(m_fCrossoverFrequency, (float)m_nSampleRate);
+}
+
+void CAmbisonicDecoder::UpdateDecoderMatrix()
+{
+    for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    {
+        // 3D: the spherical harmonic coefficients are multiplied by (2*order + 1) to provide the correct decoder
+        // for SN3D normalised Ambisonic inputs.
+        // 2D: the spherical harmonic coefficients are multiplied by 2 to provide the correct decoder
+        // for SN3D normalised Ambisonic inputs decoded to a horizontal loudspeaker array
+        float fScale = 2.f;
+        if(m_b3D)
+            fScale = 2.f * (unsigned)sqrtf((float)niChannel) + 1.f;
+
+        for(unsigned niSpeaker = 0; niSpeaker < m_nSpeakers; niSpeaker++)
+            m_pfDecoderMatrix[niSpeaker * m_nChannelCount + niChannel] =
+                    m_pAmbSpeakers[niSpeaker].GetCoefficient(niChannel) * fScale;
     }
+    m_bDecoderMatrixDirty = false;
 }
 
 int CAmbisonicDecoder::GetSpeakerSetUp()
@@ -99,6 +281,7 @@ float CAmbisonicDecoder::GetCoefficient(unsigned nSpeaker, unsigned nChannel)
 void CAmbisonicDecoder::SetCoefficient(unsigned nSpeaker, unsigned nChannel, float fCoeff)
 {
     m_pAmbSpeakers[nSpeaker].SetCoefficient(nChannel, fCoeff);
+    m_bDecoderMatrixDirty = true;
 }
 
 void CAmbisonicDecoder::SpeakerSetUp(int nSpeakerSetUp, unsigned nSpeakers)
@@ -17,6 +17,8 @@
 
 
 CAmbisonicEncoder::CAmbisonicEncoder()
+    : m_bInterpolate(false)
+    , m_bCoeffPreviousValid(false)
 { }
 
 CAmbisonicEncoder::~CAmbisonicEncoder()
@@ -28,7 +30,10 @@ bool CAmbisonicEncoder::Configure(unsigned nOrder, bool b3D, unsigned nMisc)
     if(!success)
         return false;
     //SetOrderWeight(0, 1.f / sqrtf(2.f)); // Removed as seems to break SN3D normalisation
-    
+
+    m_pfCoeffPrevious.assign(m_nChannelCount, 0.f);
+    m_bCoeffPreviousValid = false;
+
     return true;
 }
 
@@ -41,11 +46,53 @@ void CAmbisonicEncoder::Process(float* pfSrc, unsigned nSamples, CBFormat* pfDst
 {
     unsigned niChannel = 0;
     unsigned niSample = 0;
+
+    //Parameters posted by a control thread
+    if(ApplyPostedParameters())
+        Refresh();
+
+    // The first block after Configure() has nothing to ramp from
+    bool bRamp = m_bInterpolate && m_bCoeffPreviousValid && nSamples > 0;
+
     for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
     {
-        for(niSample = 0; niSample < nSamples; niSample++)
+        const float* __restrict pfIn = pfSrc;
+        float* __restrict pfOut = pfDst->m_ppfChannels[niChannel];
+        float fCoeff = m_pfCoeff[niChannel];
+
+        if(bRamp && m_pfCoeffPrevious[niChannel] != fCoeff)
+        {
+            // Reaches the new coefficient on the last sample of the block
+            float fStep = (fCoeff - m_pfCoeffPrevious[niChannel]) / nSamples;
+            float fStart = m_pfCoeffPrevious[niChannel] + fStep;
+            for(niSample = 0; niSample < nSamples; niSample++)
+            {
+                pfOut[niSample] = pfIn[niSample] * (fStart + fStep * niSample);
+            }
+        }
+        else
         {
-            pfDst->m_ppfChannels[niChannel][niSample] = pfSrc[niSample] * m_pfCoeff[niChannel];
+            for(niSample = 0; niSample < nSamples; niSample++)
+            {
+                pfOut[niSample] = pfIn[niSample] * fCoeff;
+            }
         }
     }
+
+    if(m_bInterpolate)
+    {
+        m_pfCoeffPrevious = m_pfCoeff;
+        m_bCoeffPreviousValid = true;
+    }
+}
+
+void CAmbisonicEncoder::SetInterpolation(bool bInterpolate)
+{
+    m_bInterpolate = bInterpolate;
+    m_bCoeffPreviousValid = false;
+}
+
+bool CAmbisonicEncoder::GetInterpolation()
+{
+    return m_bInterpolate;
 }
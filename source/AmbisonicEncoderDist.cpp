@@ -46,6 +46,7 @@ bool CAmbisonicEncoderDist::Configure(unsigned nOrder, bool b3D, unsigned nSampl
 
     m_pfDelayBuffer.clear();
     m_pfDelayBuffer.resize(m_nDelayBufferLength);
+    m_pfGainStep.assign(m_nChannelCount, 0.f);
 
     Reset();
     
@@ -95,6 +96,21 @@ void CAmbisonicEncoderDist::Process(float* pfSrc, unsigned nSamples, CBFormat* p
     unsigned niSample = 0;
     float fSrcSample = 0;
 
+    //Parameters posted by a control thread
+    if(ApplyPostedParameters())
+        Refresh();
+
+    // The first block after Configure() has nothing to ramp from
+    bool bRamp = m_bInterpolate && m_bCoeffPreviousValid && nSamples > 0;
+
+    //Ramp the gain of each channel, coefficient and interior/exterior gain together,
+    //from the previous block. The delay changes at once.
+    if(bRamp)
+    {
+        for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+            m_pfGainStep[niChannel] = (GetChannelGain(niChannel) - m_pfCoeffPrevious[niChannel]) / nSamples;
+    }
+
     for(niSample = 0; niSample < nSamples; niSample++)
     {
         //Store
@@ -103,18 +119,42 @@ void CAmbisonicEncoderDist::Process(float* pfSrc, unsigned nSamples, CBFormat* p
         fSrcSample = m_pfDelayBuffer[m_nOutA] * (1.f - m_fDelay)
                     + m_pfDelayBuffer[m_nOutB] * m_fDelay;
 
-        pfDst->m_ppfChannels[kW][niSample] = fSrcSample * m_fInteriorGain * m_pfCoeff[kW];
-
-        fSrcSample *= m_fExteriorGain;
-        for(niChannel = 1; niChannel < m_nChannelCount; niChannel++)
+        if(bRamp)
         {
-            pfDst->m_ppfChannels[niChannel][niSample] = fSrcSample * m_pfCoeff[niChannel];
+            float fRamp = (float)(niSample + 1);
+            for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+            {
+                pfDst->m_ppfChannels[niChannel][niSample] = fSrcSample
+                    * (m_pfCoeffPrevious[niChannel] + m_pfGainStep[niChannel] * fRamp);
+            }
+        }
+        else
+        {
+            pfDst->m_ppfChannels[kW][niSample] = fSrcSample * m_fInteriorGain * m_pfCoeff[kW];
+
+            fSrcSample *= m_fExteriorGain;
+            for(niChannel = 1; niChannel < m_nChannelCount; niChannel++)
+            {
+                pfDst->m_ppfChannels[niChannel][niSample] = fSrcSample * m_pfCoeff[niChannel];
+            }
         }
 
         m_nIn = (m_nIn + 1) % m_nDelayBufferLength;
         m_nOutA = (m_nOutA + 1) % m_nDelayBufferLength;
         m_nOutB = (m_nOutB + 1) % m_nDelayBufferLength;
     }
+
+    if(m_bInterpolate)
+    {
+        for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+            m_pfCoeffPrevious[niChannel] = GetChannelGain(niChannel);
+        m_bCoeffPreviousValid = true;
+    }
+}
+
+float CAmbisonicEncoderDist::GetChannelGain(unsigned nChannel)
+{
+    return m_pfCoeff[nChannel] * (nChannel == kW ? m_fInteriorGain : m_fExteriorGain);
 }
 
 void CAmbisonicEncoderDist::SetRoomRadius(float fRoomRadius)
@@ -36,6 +36,10 @@ void CAmbisonicMicrophone::Process(CBFormat* pBFSrc, unsigned nSamples, float* p
     unsigned niSample = 0;
     float fTempA = 0;
     float fTempB = 0;
+
+    //Parameters posted by a control thread
+    if(ApplyPostedParameters())
+        Refresh();
     for(niSample = 0; niSample < nSamples; niSample++)
     {
         fTempA = pBFSrc->m_ppfChannels[0][niSample] * m_pfCoeff[0];
@@ -57,3 +61,20 @@ float CAmbisonicMicrophone::GetDirectivity()
 {
     return m_fDirectivity;
 }
+
+void CAmbisonicMicrophone::PostDirectivity(float fDirectivity)
+{
+    m_DirectivityQueue.Push(fDirectivity);
+}
+
+bool CAmbisonicMicrophone::ApplyPostedParameters()
+{
+    bool bChanged = CAmbisonicSource::ApplyPostedParameters();
+    float fDirectivity;
+    if(m_DirectivityQueue.PopLatest(fDirectivity))
+    {
+        SetDirectivity(fDirectivity);
+        bChanged = true;
+    }
+    return bChanged;
+}
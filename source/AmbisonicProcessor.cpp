@@ -15,45 +15,15 @@
 
 
 #include "AmbisonicProcessor.h"
-#include <iostream>
+#include <algorithm>
 
 CAmbisonicProcessor::CAmbisonicProcessor()
     : m_orientation(0, 0, 0)
+    , m_OrientationQueue(Orientation(0, 0, 0))
 {
-    m_pfTempSample = nullptr;
-    m_pfScratchBufferA = nullptr;
-    m_pFFT_psych_cfg = nullptr;
-    m_pIFFT_psych_cfg = nullptr;
-    m_ppcpPsychFilters = nullptr;
-    m_pcpScratch = nullptr;
-    m_pfOverlap = nullptr;
-}
-
-CAmbisonicProcessor::~CAmbisonicProcessor()
-{
-    if(m_pfTempSample)
-        delete [] m_pfTempSample;
-    if(m_pfScratchBufferA)
-        delete [] m_pfScratchBufferA;
-    if(m_pFFT_psych_cfg)
-        kiss_fftr_free(m_pFFT_psych_cfg);
-    if(m_pIFFT_psych_cfg)
-        kiss_fftr_free(m_pIFFT_psych_cfg);
-    if (m_ppcpPsychFilters)
-    {
-        for(unsigned i=0; i<=m_nOrder; i++)
-            if(m_ppcpPsychFilters[i])
-                delete [] m_ppcpPsychFilters[i];
-        delete [] m_ppcpPsychFilters;
-    }
-    if(m_pcpScratch)
-        delete [] m_pcpScratch;
-    if(m_pfOverlap){
-        for(unsigned i=0; i<m_nChannelCount; i++)
-            if(m_pfOverlap[i])
-                delete [] m_pfOverlap[i];
-        delete [] m_pfOverlap;
-    }
+    m_nRampLength = 0;
+    m_nRampPosition = 0;
+    m_eShelfFilter = kShelfFIR;
 }
 
 bool CAmbisonicProcessor::Configure(unsigned nOrder, bool b3D, unsigned nBlockSize, unsigned nMisc)
@@ -61,13 +31,19 @@ bool CAmbisonicProcessor::Configure(unsigned nOrder, bool b3D, unsigned nBlockSi
     bool success = CAmbisonicBase::Configure(nOrder, b3D, nMisc);
     if(!success)
         return false;
-    if(m_pfTempSample)
-        delete [] m_pfTempSample;
-    m_pfTempSample = new float[m_nChannelCount];
-    memset(m_pfTempSample, 0, m_nChannelCount * sizeof(float));
+    m_pfTempSample.assign((2 * m_nOrder + 1) * knRotationChunk, 0.f);
 
-    /* This bool should be set as a user option to turn optimisation on and off*/
-    m_bOpt = true;
+    m_ppfRotation.resize(m_nOrder + 1);
+    m_ppfRotationStart.resize(m_nOrder + 1);
+    for(unsigned i = 0; i <= m_nOrder; i++)
+    {
+        m_ppfRotation[i].assign((2 * i + 1) * (2 * i + 1), 0.f);
+        m_ppfRotationStart[i].assign((2 * i + 1) * (2 * i + 1), 0.f);
+    }
+
+    /* The optimisation can be turned off with SetShelfFilter(kShelfNone) */
+    /* The optimisation filters are only designed for orders 1 to 3, order 0 has none */
+    m_bOpt = m_nOrder >= 1 && m_nOrder <= 3;
 
     // All optimisation filters have the same number of taps so take from the first order 3D impulse response arbitrarily
     unsigned nbTaps = sizeof(first_order_3D[0]) / sizeof(int16_t);
@@ -87,16 +63,14 @@ bool CAmbisonicProcessor::Configure(unsigned nOrder, bool b3D, unsigned nBlockSi
     m_fFFTScaler = 1.f / m_nFFTSize;
 
     //Allocate buffers
-        m_pfOverlap = new float*[m_nChannelCount];
-    for(unsigned i=0; i<m_nChannelCount; i++)
-        m_pfOverlap[i] = new float[m_nOverlapLength];
+    m_pfOverlap.assign(m_nChannelCount, std::vector<float>(m_nOverlapLength));
 
-    m_pfScratchBufferA = new float[m_nFFTSize];
-    m_ppcpPsychFilters = new kiss_fft_cpx*[m_nOrder+1];
+    m_pfScratchBufferA.assign(m_nFFTSize, 0.f);
+    m_ppcpPsychFilters.resize(m_nOrder + 1);
     for(unsigned i = 0; i <= m_nOrder; i++)
-        m_ppcpPsychFilters[i] = new kiss_fft_cpx[m_nFFTBins];
+        m_ppcpPsychFilters[i].reset(new kiss_fft_cpx[m_nFFTBins]());
 
-    m_pcpScratch = new kiss_fft_cpx[m_nFFTBins];
+    m_pcpScratch.reset(new kiss_fft_cpx[m_nFFTBins]);
 
     //Allocate temporary buffers for retrieving taps of psychoacoustic opimisation filters
     std::vector<std::unique_ptr<float[]>> pfPsychIR;
@@ -108,12 +82,13 @@ bool CAmbisonicProcessor::Configure(unsigned nOrder, bool b3D, unsigned nBlockSi
     Reset();
 
     //Allocate FFT and iFFT for new size
-    m_pFFT_psych_cfg = kiss_fftr_alloc(m_nFFTSize, 0, 0, 0);
-    m_pIFFT_psych_cfg = kiss_fftr_alloc(m_nFFTSize, 1, 0, 0);
+    m_pFFT_psych.reset(createFFT(m_nFFTSize));
+    if (!m_pFFT_psych)
+        return false;
 
     // get impulse responses for psychoacoustic optimisation based on playback system (2D or 3D) and playback order (1 to 3)
     //Convert from short to float representation
-    for (unsigned i_m = 0; i_m <= m_nOrder; i_m++){
+    for (unsigned i_m = 0; m_bOpt && i_m <= m_nOrder; i_m++){
         for(unsigned i = 0; i < m_nTaps; i++)
             if(m_b3D){
                 switch(m_nOrder){
@@ -130,41 +105,179 @@ bool CAmbisonicProcessor::Configure(unsigned nOrder, bool b3D, unsigned nBlockSi
                 }
             }
         // Convert the impulse responses to the frequency domain
-        memcpy(m_pfScratchBufferA, pfPsychIR[i_m].get(), m_nTaps * sizeof(float));
+        memcpy(m_pfScratchBufferA.data(), pfPsychIR[i_m].get(), m_nTaps * sizeof(float));
         memset(&m_pfScratchBufferA[m_nTaps], 0, (m_nFFTSize - m_nTaps) * sizeof(float));
-        kiss_fftr(m_pFFT_psych_cfg, m_pfScratchBufferA, m_ppcpPsychFilters[i_m]);
+        m_pFFT_psych->forward(m_pfScratchBufferA.data(), m_ppcpPsychFilters[i_m].get());
     }
 
+    // Minimum phase versions of the same filters, used when kShelfIIR is selected
+    m_ShelfIIR.assign(m_nChannelCount * knMaxShelfSections, CBiquad());
+    m_pnShelfSections.assign(m_nOrder + 1, 0);
+    m_pfShelfGain.assign(m_nOrder + 1, 1.f);
+    for (unsigned i_m = 0; m_bOpt && i_m <= m_nOrder; i_m++){
+        const PsychoacousticShelf* pShelf = nullptr;
+        if(m_b3D){
+            switch(m_nOrder){
+                case 1: pShelf = &first_order_3D_iir[i_m]; break;
+                case 2: pShelf = &second_order_3D_iir[i_m]; break;
+                case 3: pShelf = &third_order_3D_iir[i_m]; break;
+            }
+        }
+        else{
+            switch(m_nOrder){
+                case 1: pShelf = &first_order_2D_iir[i_m]; break;
+                case 2: pShelf = &second_order_2D_iir[i_m]; break;
+                case 3: pShelf = &third_order_2D_iir[i_m]; break;
+            }
+        }
+        m_pnShelfSections[i_m] = pShelf->nSections;
+        m_pfShelfGain[i_m] = pShelf->fGain;
+        float fSectionGain = powf(pShelf->fShelfGain, 1.f / pShelf->nSections);
+        for(unsigned niChannel = i_m * i_m; niChannel < (i_m + 1) * (i_m + 1) && niChannel < m_nChannelCount; niChannel++)
+        {
+            for(unsigned niSection = 0; niSection < pShelf->nSections; niSection++)
+                m_ShelfIIR[niChannel * knMaxShelfSections + niSection].SetHighShelf(pShelf->fFrequency, 1.f, fSectionGain, pShelf->fQ);
+        }
+    }
+
+    // Start at the current orientation without ramping from silence
+    Refresh();
+    m_ppfRotationStart = m_ppfRotation;
+    m_nRampPosition = m_nRampLength;
+
     return true;
 }
 
 void CAmbisonicProcessor::Reset()
 {
     for(unsigned i=0; i<m_nChannelCount; i++)
-        memset(m_pfOverlap[i], 0, m_nOverlapLength * sizeof(float));
+        memset(m_pfOverlap[i].data(), 0, m_nOverlapLength * sizeof(float));
+    for(auto& shelf : m_ShelfIIR)
+        shelf.Reset();
 }
 
 void CAmbisonicProcessor::Refresh()
 {
-    // Trig terms used multiple times in rotation equations
-    m_fCosAlpha = cosf(m_orientation.fAlpha);
-    m_fSinAlpha = sinf(m_orientation.fAlpha);
-    m_fCosBeta = cosf(m_orientation.fBeta);
-    m_fSinBeta = sinf(m_orientation.fBeta);
-    m_fCosGamma = cosf(m_orientation.fGamma);
-    m_fSinGamma = sinf(m_orientation.fGamma);
-    m_fCos2Alpha = cosf(2.f * m_orientation.fAlpha);
-    m_fSin2Alpha = sinf(2.f * m_orientation.fAlpha);
-    m_fCos2Beta = cosf(2.f * m_orientation.fBeta);
-    m_fSin2Beta = sinf(2.f * m_orientation.fBeta);
-    m_fCos2Gamma = cosf(2.f * m_orientation.fGamma);
-    m_fSin2Gamma = sinf(2.f * m_orientation.fGamma);
-    m_fCos3Alpha = cosf(3.f * m_orientation.fAlpha);
-    m_fSin3Alpha = sinf(3.f * m_orientation.fAlpha);
-    m_fCos3Beta = cosf(3.f * m_orientation.fBeta);
-    m_fSin3Beta = sinf(3.f * m_orientation.fBeta);
-    m_fCos3Gamma = cosf(3.f * m_orientation.fGamma);
-    m_fSin3Gamma = sinf(3.f * m_orientation.fGamma);
+    // Rotation matrices of each order, composed once per orientation change.
+    // The first order matrix is the rotation of the (y, z, x) axes. The rotations are performed in the following order:
+    //    1 - rotation around the z-axis (alpha)
+    //    2 - rotation around the *new* y-axis (beta)
+    //    3 - rotation around the new z-axis (gamma)
+    // This is different to the rotations obtained from the video, which are around z, y' then x''.
+    // The matrices of the higher orders are built recursively from it.
+    if(m_nOrder < 1)
+        return;
+
+    // The ramp towards the new matrices starts from the matrices currently applied,
+    // which may be part way through the previous ramp
+    if(m_nRampLength > 0)
+    {
+        float fPosition = (float)m_nRampPosition / m_nRampLength;
+        for(unsigned nOrder = 1; nOrder <= m_nOrder; nOrder++)
+            for(size_t k = 0; k < m_ppfRotation[nOrder].size(); k++)
+                m_ppfRotationStart[nOrder][k] += (m_ppfRotation[nOrder][k] - m_ppfRotationStart[nOrder][k]) * fPosition;
+        m_nRampPosition = 0;
+    }
+
+    float fCosAlpha = cosf(m_orientation.fAlpha);
+    float fSinAlpha = sinf(m_orientation.fAlpha);
+    float fCosBeta = cosf(m_orientation.fBeta);
+    float fSinBeta = sinf(m_orientation.fBeta);
+    float fCosGamma = cosf(m_orientation.fGamma);
+    float fSinGamma = sinf(m_orientation.fGamma);
+
+    // Rows and columns in ACN order: Y, Z, X
+    const float pfAlpha[3][3] = {
+        { fCosAlpha, 0.f, -fSinAlpha },
+        { 0.f, 1.f, 0.f },
+        { fSinAlpha, 0.f, fCosAlpha } };
+    const float pfBeta[3][3] = {
+        { 1.f, 0.f, 0.f },
+        { 0.f, fCosBeta, fSinBeta },
+        { 0.f, -fSinBeta, fCosBeta } };
+    const float pfGamma[3][3] = {
+        { fCosGamma, 0.f, -fSinGamma },
+        { 0.f, 1.f, 0.f },
+        { fSinGamma, 0.f, fCosGamma } };
+
+    float pfBetaAlpha[3][3];
+    for(unsigned i = 0; i < 3; i++)
+        for(unsigned j = 0; j < 3; j++)
+            pfBetaAlpha[i][j] = pfBeta[i][0] * pfAlpha[0][j] + pfBeta[i][1] * pfAlpha[1][j] + pfBeta[i][2] * pfAlpha[2][j];
+    float* pfRotation = m_ppfRotation[1].data();
+    for(unsigned i = 0; i < 3; i++)
+        for(unsigned j = 0; j < 3; j++)
+            pfRotation[i * 3 + j] = pfGamma[i][0] * pfBetaAlpha[0][j] + pfGamma[i][1] * pfBetaAlpha[1][j] + pfGamma[i][2] * pfBetaAlpha[2][j];
+
+    for(unsigned nOrder = 2; nOrder <= m_nOrder; nOrder++)
+        RecurseRotationMatrix(nOrder, m_ppfRotation[1].data(), m_ppfRotation[nOrder - 1].data(), m_ppfRotation[nOrder].data());
+}
+
+namespace {
+    /** Helper of the Ivanic-Ruedenberg recursion. pfR1 is the first order matrix and
+        pfPrev the matrix of order nOrder - 1, both indexed by degree (-l..l). */
+    float RecursionP(int i, int nOrder, int a, int b, const float* pfR1, const float* pfPrev)
+    {
+        const int nPrevBand = 2 * nOrder - 1;
+        auto R1 = [pfR1](int m, int n) { return pfR1[(m + 1) * 3 + (n + 1)]; };
+        auto Prev = [pfPrev, nOrder, nPrevBand](int m, int n) { return pfPrev[(m + nOrder - 1) * nPrevBand + (n + nOrder - 1)]; };
+
+        if(b == nOrder)
+            return R1(i, 1) * Prev(a, nOrder - 1) - R1(i, -1) * Prev(a, -nOrder + 1);
+        else if(b == -nOrder)
+            return R1(i, 1) * Prev(a, -nOrder + 1) + R1(i, -1) * Prev(a, nOrder - 1);
+        else
+            return R1(i, 0) * Prev(a, b);
+    }
+}
+
+void CAmbisonicProcessor::RecurseRotationMatrix(unsigned nOrder, const float* pfR1, const float* pfPrev, float* pfMatrix)
+{
+    // Ivanic and Ruedenberg, "Rotation Matrices for Real Spherical Harmonics. Direct Determination
+    // by Recursion", J. Phys. Chem. 1996 (with the 1998 corrections).
+    // The matrix of each order only depends on the first order matrix and the previous order,
+    // so any order can be reached. Normalisation (SN3D/N3D) is a per-order scale so does not change the matrix.
+    const int l = (int)nOrder;
+    const int nBand = 2 * l + 1;
+
+    for(int m = -l; m <= l; m++)
+    {
+        const int nAbsM = m < 0 ? -m : m;
+        const float fDeltaM0 = m == 0 ? 1.f : 0.f;
+
+        for(int n = -l; n <= l; n++)
+        {
+            const float fDenom = (n == l || n == -l) ? (float)(2 * l * (2 * l - 1)) : (float)((l + n) * (l - n));
+
+            const float fU = sqrtf((l + m) * (l - m) / fDenom);
+            const float fV = 0.5f * sqrtf((1.f + fDeltaM0) * (l + nAbsM - 1) * (l + nAbsM) / fDenom) * (1.f - 2.f * fDeltaM0);
+            const float fW = -0.5f * sqrtf((l - nAbsM - 1) * (l - nAbsM) / fDenom) * (1.f - fDeltaM0);
+
+            float fValue = 0.f;
+            if(fU != 0.f)
+                fValue += fU * RecursionP(0, l, m, n, pfR1, pfPrev);
+            if(fV != 0.f)
+            {
+                float fTermV;
+                if(m == 0)
+                    fTermV = RecursionP(1, l, 1, n, pfR1, pfPrev) + RecursionP(-1, l, -1, n, pfR1, pfPrev);
+                else if(m > 0)
+                    fTermV = m == 1 ? sqrtf(2.f) * RecursionP(1, l, 0, n, pfR1, pfPrev)
+                                    : RecursionP(1, l, m - 1, n, pfR1, pfPrev) - RecursionP(-1, l, -m + 1, n, pfR1, pfPrev);
+                else
+                    fTermV = m == -1 ? sqrtf(2.f) * RecursionP(-1, l, 0, n, pfR1, pfPrev)
+                                     : RecursionP(1, l, m + 1, n, pfR1, pfPrev) + RecursionP(-1, l, -m - 1, n, pfR1, pfPrev);
+                fValue += fV * fTermV;
+            }
+            if(fW != 0.f)
+            {
+                float fTermW = m > 0 ? RecursionP(1, l, m + 1, n, pfR1, pfPrev) + RecursionP(-1, l, -m - 1, n, pfR1, pfPrev)
+                                     : RecursionP(1, l, m - 1, n, pfR1, pfPrev) - RecursionP(-1, l, -m + 1, n, pfR1, pfPrev);
+                fValue += fW * fTermW;
+            }
+            pfMatrix[(m + l) * nBand + (n + l)] = fValue;
+        }
+    }
 }
 
 void CAmbisonicProcessor::SetOrientation(Orientation orientation)
@@ -172,6 +285,34 @@ void CAmbisonicProcessor::SetOrientation(Orientation orientation)
     m_orientation = orientation;
 }
 
+void CAmbisonicProcessor::PostOrientation(Orientation orientation)
+{
+    m_OrientationQueue.Push(orientation);
+}
+
+void CAmbisonicProcessor::SetRampLength(unsigned nSamples)
+{
+    m_nRampLength = nSamples;
+    m_nRampPosition = nSamples;
+    m_ppfRotationStart = m_ppfRotation;
+}
+
+unsigned CAmbisonicProcessor::GetRampLength()
+{
+    return m_nRampLength;
+}
+
+void CAmbisonicProcessor::SetShelfFilter(ProcessorShelfFilters eShelfFilter)
+{
+    m_eShelfFilter = eShelfFilter;
+    Reset();
+}
+
+ProcessorShelfFilters CAmbisonicProcessor::GetShelfFilter()
+{
+    return m_eShelfFilter;
+}
+
 Orientation CAmbisonicProcessor::GetOrientation()
 {
     return m_orientation;
@@ -179,12 +320,22 @@ Orientation CAmbisonicProcessor::GetOrientation()
 
 void CAmbisonicProcessor::Process(CBFormat* pBFSrcDst, unsigned nSamples)
 {
+    //Orientation posted by a control thread
+    Orientation orientation = m_orientation;
+    if(m_OrientationQueue.PopLatest(orientation))
+    {
+        SetOrientation(orientation);
+        Refresh();
+    }
 
     /* Rotate the sound scene based on the rotation angle from the 360 video*/
     /* Before the rotation we apply the psychoacoustic optimisation filters */
-    if(m_bOpt)
+    if(m_bOpt && m_eShelfFilter != kShelfNone)
     {
-        ShelfFilterOrder(pBFSrcDst, nSamples);
+        if(m_eShelfFilter == kShelfIIR)
+            ShelfFilterOrderIIR(pBFSrcDst, nSamples);
+        else
+            ShelfFilterOrder(pBFSrcDst, nSamples);
     }
     else
     {
@@ -192,177 +343,68 @@ void CAmbisonicProcessor::Process(CBFormat* pBFSrcDst, unsigned nSamples)
     }
 
     /* 3D Ambisonics input expected so perform 3D rotations */
-    if(m_nOrder >= 1)
-        ProcessOrder1_3D(pBFSrcDst, nSamples);
-    if(m_nOrder >= 2)
-        ProcessOrder2_3D(pBFSrcDst, nSamples);
-    if(m_nOrder >= 3)
-        ProcessOrder3_3D(pBFSrcDst, nSamples);
-}
-
-void CAmbisonicProcessor::ProcessOrder1_3D(CBFormat* pBFSrcDst, unsigned nSamples)
-{
-    /* Rotations are performed in the following order:
-        1 - rotation around the z-axis
-        2 - rotation around the *new* y-axis (y')
-        3 - rotation around the new z-axis (z'')
-    This is different to the rotations obtained from the video, which are around z, y' then x''.
-    The rotation equations used here work for third order. However, for higher orders a recursive algorithm
-    should be considered.*/
-    for(unsigned niSample = 0; niSample < nSamples; niSample++)
-    {
-        // Alpha rotation
-        m_pfTempSample[kY] = -pBFSrcDst->m_ppfChannels[kX][niSample] * m_fSinAlpha
-                            + pBFSrcDst->m_ppfChannels[kY][niSample] * m_fCosAlpha;
-        m_pfTempSample[kZ] = pBFSrcDst->m_ppfChannels[kZ][niSample];
-        m_pfTempSample[kX] = pBFSrcDst->m_ppfChannels[kX][niSample] * m_fCosAlpha
-                            + pBFSrcDst->m_ppfChannels[kY][niSample] * m_fSinAlpha;
-
-        // Beta rotation
-        pBFSrcDst->m_ppfChannels[kY][niSample] = m_pfTempSample[kY];
-        pBFSrcDst->m_ppfChannels[kZ][niSample] = m_pfTempSample[kZ] * m_fCosBeta
-                            +  m_pfTempSample[kX] * m_fSinBeta;
-        pBFSrcDst->m_ppfChannels[kX][niSample] = m_pfTempSample[kX] * m_fCosBeta
-                            - m_pfTempSample[kZ] * m_fSinBeta;
-
-        // Gamma rotation
-        m_pfTempSample[kY] = -pBFSrcDst->m_ppfChannels[kX][niSample] * m_fSinGamma
-                            + pBFSrcDst->m_ppfChannels[kY][niSample] * m_fCosGamma;
-        m_pfTempSample[kZ] = pBFSrcDst->m_ppfChannels[kZ][niSample];
-        m_pfTempSample[kX] = pBFSrcDst->m_ppfChannels[kX][niSample] * m_fCosGamma
-                            + pBFSrcDst->m_ppfChannels[kY][niSample] * m_fSinGamma;
+    for(unsigned nOrder = 1; nOrder <= m_nOrder; nOrder++)
+        ProcessOrder(pBFSrcDst->m_ppfChannels.get(), nOrder, nSamples);
 
-        pBFSrcDst->m_ppfChannels[kX][niSample] = m_pfTempSample[kX];
-        pBFSrcDst->m_ppfChannels[kY][niSample] = m_pfTempSample[kY];
-        pBFSrcDst->m_ppfChannels[kZ][niSample] = m_pfTempSample[kZ];
-    }
+    m_nRampPosition = m_nRampLength - m_nRampPosition > nSamples ? m_nRampPosition + nSamples : m_nRampLength;
 }
 
-void CAmbisonicProcessor::ProcessOrder2_3D(CBFormat* pBFSrcDst, unsigned nSamples)
+void CAmbisonicProcessor::ProcessOrder(float** ppfChannels, unsigned nOrder, unsigned nSamples)
 {
-    float fSqrt3 = sqrt(3.f);
-
-    for(unsigned niSample = 0; niSample < nSamples; niSample++)
+    // Apply the composed rotation matrix of one order. The block is processed in short
+    // chunks: the input of the chunk is copied once, then each output channel is
+    // accumulated over the whole chunk so the inner loops are straight vector code
+    // and every sample is read and written once.
+    const unsigned nBand = 2 * nOrder + 1;
+    const unsigned nFirst = nOrder * nOrder;
+    const float* pfMatrix = m_ppfRotation[nOrder].data();
+    const float* pfStart = m_ppfRotationStart[nOrder].data();
+    const float fRampScale = m_nRampLength > 0 ? 1.f / m_nRampLength : 0.f;
+    float* __restrict pfIn = m_pfTempSample.data();
+
+    unsigned nChunk = 0;
+    for(unsigned niStart = 0; niStart < nSamples; niStart += nChunk)
     {
-        // Alpha rotation
-        m_pfTempSample[kV] = - pBFSrcDst->m_ppfChannels[kU][niSample] * m_fSin2Alpha
-                            + pBFSrcDst->m_ppfChannels[kV][niSample] * m_fCos2Alpha;
-        m_pfTempSample[kT] = - pBFSrcDst->m_ppfChannels[kS][niSample] * m_fSinAlpha
-                            + pBFSrcDst->m_ppfChannels[kT][niSample] * m_fCosAlpha;
-        m_pfTempSample[kR] = pBFSrcDst->m_ppfChannels[kR][niSample];
-        m_pfTempSample[kS] = pBFSrcDst->m_ppfChannels[kS][niSample] * m_fCosAlpha
-                            + pBFSrcDst->m_ppfChannels[kT][niSample] * m_fSinAlpha;
-        m_pfTempSample[kU] = pBFSrcDst->m_ppfChannels[kU][niSample] * m_fCos2Alpha
-                            + pBFSrcDst->m_ppfChannels[kV][niSample] * m_fSin2Alpha;
-
-        // Beta rotation
-        pBFSrcDst->m_ppfChannels[kV][niSample] = -m_fSinBeta * m_pfTempSample[kT]
-                                        + m_fCosBeta * m_pfTempSample[kV];
-        pBFSrcDst->m_ppfChannels[kT][niSample] = -m_fCosBeta * m_pfTempSample[kT]
-                                        + m_fSinBeta * m_pfTempSample[kV];
-        pBFSrcDst->m_ppfChannels[kR][niSample] = (0.75f * m_fCos2Beta + 0.25f) * m_pfTempSample[kR]
-                            + (0.5 * fSqrt3 * pow(m_fSinBeta,2.0) ) * m_pfTempSample[kU]
-                            + (fSqrt3 * m_fSinBeta * m_fCosBeta) * m_pfTempSample[kS];
-        pBFSrcDst->m_ppfChannels[kS][niSample] = m_fCos2Beta * m_pfTempSample[kS]
-                            - fSqrt3 * m_fCosBeta * m_fSinBeta * m_pfTempSample[kR]
-                            + m_fCosBeta * m_fSinBeta * m_pfTempSample[kU];
-        pBFSrcDst->m_ppfChannels[kU][niSample] = (0.25f * m_fCos2Beta + 0.75f) * m_pfTempSample[kU]
-                            - m_fCosBeta * m_fSinBeta * m_pfTempSample[kS]
-                            +0.5 * fSqrt3 * pow(m_fSinBeta,2.0) * m_pfTempSample[kR];
-
-        // Gamma rotation
-        m_pfTempSample[kV] = - pBFSrcDst->m_ppfChannels[kU][niSample] * m_fSin2Gamma
-                            + pBFSrcDst->m_ppfChannels[kV][niSample] * m_fCos2Gamma;
-        m_pfTempSample[kT] = - pBFSrcDst->m_ppfChannels[kS][niSample] * m_fSinGamma
-                            + pBFSrcDst->m_ppfChannels[kT][niSample] * m_fCosGamma;
-
-        m_pfTempSample[kR] = pBFSrcDst->m_ppfChannels[kR][niSample];
-        m_pfTempSample[kS] = pBFSrcDst->m_ppfChannels[kS][niSample] * m_fCosGamma
-                            + pBFSrcDst->m_ppfChannels[kT][niSample] * m_fSinGamma;
-        m_pfTempSample[kU] = pBFSrcDst->m_ppfChannels[kU][niSample] * m_fCos2Gamma
-                            + pBFSrcDst->m_ppfChannels[kV][niSample] * m_fSin2Gamma;
-
-        pBFSrcDst->m_ppfChannels[kR][niSample] = m_pfTempSample[kR];
-        pBFSrcDst->m_ppfChannels[kS][niSample] = m_pfTempSample[kS];
-        pBFSrcDst->m_ppfChannels[kT][niSample] = m_pfTempSample[kT];
-        pBFSrcDst->m_ppfChannels[kU][niSample] = m_pfTempSample[kU];
-        pBFSrcDst->m_ppfChannels[kV][niSample] = m_pfTempSample[kV];
-    }
-}
+        nChunk = nSamples - niStart < knRotationChunk ? nSamples - niStart : knRotationChunk;
 
-void CAmbisonicProcessor::ProcessOrder3_3D(CBFormat* pBFSrcDst, unsigned nSamples)
-{
-        /* (should move these somewhere that does recompute each time) */
-        float fSqrt3_2 = sqrt(3.f/2.f);
-        float fSqrt15 = sqrt(15.f);
-        float fSqrt5_2 = sqrt(5.f/2.f);
+        // A chunk is either entirely inside the ramp or entirely after it
+        unsigned nRampPosition = m_nRampPosition + niStart;
+        bool bRamp = nRampPosition < m_nRampLength;
+        if(bRamp && m_nRampLength - nRampPosition < nChunk)
+            nChunk = m_nRampLength - nRampPosition;
 
-    for(unsigned niSample = 0; niSample < nSamples; niSample++)
-    {
-        // Alpha rotation
-        m_pfTempSample[kQ] = - pBFSrcDst->m_ppfChannels[kP][niSample] * m_fSin3Alpha
-                            + pBFSrcDst->m_ppfChannels[kQ][niSample] * m_fCos3Alpha;
-        m_pfTempSample[kO] = - pBFSrcDst->m_ppfChannels[kN][niSample] * m_fSin2Alpha
-                            + pBFSrcDst->m_ppfChannels[kO][niSample] * m_fCos2Alpha;
-        m_pfTempSample[kM] = - pBFSrcDst->m_ppfChannels[kL][niSample] * m_fSinAlpha
-                            + pBFSrcDst->m_ppfChannels[kM][niSample] * m_fCosAlpha;
-        m_pfTempSample[kK] = pBFSrcDst->m_ppfChannels[kK][niSample];
-        m_pfTempSample[kL] = pBFSrcDst->m_ppfChannels[kL][niSample] * m_fCosAlpha
-                            + pBFSrcDst->m_ppfChannels[kM][niSample] * m_fSinAlpha;
-        m_pfTempSample[kN] = pBFSrcDst->m_ppfChannels[kN][niSample] * m_fCos2Alpha
-                            + pBFSrcDst->m_ppfChannels[kO][niSample] * m_fSin2Alpha;
-        m_pfTempSample[kP] = pBFSrcDst->m_ppfChannels[kP][niSample] * m_fCos3Alpha
-                            + pBFSrcDst->m_ppfChannels[kQ][niSample] * m_fSin3Alpha;
-
-        // Beta rotation
-        pBFSrcDst->m_ppfChannels[kQ][niSample] = 0.125f * m_pfTempSample[kQ] * (5.f + 3.f*m_fCos2Beta)
-                    - fSqrt3_2 * m_pfTempSample[kO] *m_fCosBeta * m_fSinBeta
-                    + 0.25f * fSqrt15 * m_pfTempSample[kM] * pow(m_fSinBeta,2.0f);
-        pBFSrcDst->m_ppfChannels[kO][niSample] = m_pfTempSample[kO] * m_fCos2Beta
-                    - fSqrt5_2 * m_pfTempSample[kM] * m_fCosBeta * m_fSinBeta
-                    + fSqrt3_2 * m_pfTempSample[kQ] * m_fCosBeta * m_fSinBeta;
-        pBFSrcDst->m_ppfChannels[kM][niSample] = 0.125f * m_pfTempSample[kM] * (3.f + 5.f*m_fCos2Beta)
-                    - fSqrt5_2 * m_pfTempSample[kO] *m_fCosBeta * m_fSinBeta
-                    + 0.25f * fSqrt15 * m_pfTempSample[kQ] * pow(m_fSinBeta,2.0f);
-        pBFSrcDst->m_ppfChannels[kK][niSample] = 0.25f * m_pfTempSample[kK] * m_fCosBeta * (-1.f + 15.f*m_fCos2Beta)
-                    + 0.5f * fSqrt15 * m_pfTempSample[kN] * m_fCosBeta * pow(m_fSinBeta,2.f)
-                    + 0.5f * fSqrt5_2 * m_pfTempSample[kP] * pow(m_fSinBeta,3.f)
-                    + 0.125f * fSqrt3_2 * m_pfTempSample[kL] * (m_fSinBeta + 5.f * m_fSin3Beta);
-        pBFSrcDst->m_ppfChannels[kL][niSample] = 0.0625f * m_pfTempSample[kL] * (m_fCosBeta + 15.f * m_fCos3Beta)
-                    + 0.25f * fSqrt5_2 * m_pfTempSample[kN] * (1.f + 3.f * m_fCos2Beta) * m_fSinBeta
-                    + 0.25f * fSqrt15 * m_pfTempSample[kP] * m_fCosBeta * pow(m_fSinBeta,2.f)
-                    - 0.125 * fSqrt3_2 * m_pfTempSample[kK] * (m_fSinBeta + 5.f * m_fSin3Beta);
-        pBFSrcDst->m_ppfChannels[kN][niSample] = 0.125f * m_pfTempSample[kN] * (5.f * m_fCosBeta + 3.f * m_fCos3Beta)
-                    + 0.25f * fSqrt3_2 * m_pfTempSample[kP] * (3.f + m_fCos2Beta) * m_fSinBeta
-                    + 0.5f * fSqrt15 * m_pfTempSample[kK] * m_fCosBeta * pow(m_fSinBeta,2.f)
-                    + 0.125 * fSqrt5_2 * m_pfTempSample[kL] * (m_fSinBeta - 3.f * m_fSin3Beta);
-        pBFSrcDst->m_ppfChannels[kP][niSample] = 0.0625f * m_pfTempSample[kP] * (15.f * m_fCosBeta + m_fCos3Beta)
-                    - 0.25f * fSqrt3_2 * m_pfTempSample[kN] * (3.f + m_fCos2Beta) * m_fSinBeta
-                    + 0.25f * fSqrt15 * m_pfTempSample[kL] * m_fCosBeta * pow(m_fSinBeta,2.f)
-                    - 0.5 * fSqrt5_2 * m_pfTempSample[kK] * pow(m_fSinBeta,3.f);
-
-        // Gamma rotation
-        m_pfTempSample[kQ] = - pBFSrcDst->m_ppfChannels[kP][niSample] * m_fSin3Gamma
-                            + pBFSrcDst->m_ppfChannels[kQ][niSample] * m_fCos3Gamma;
-        m_pfTempSample[kO] = - pBFSrcDst->m_ppfChannels[kN][niSample] * m_fSin2Gamma
-                            + pBFSrcDst->m_ppfChannels[kO][niSample] * m_fCos2Gamma;
-        m_pfTempSample[kM] = - pBFSrcDst->m_ppfChannels[kL][niSample] * m_fSinGamma
-                            + pBFSrcDst->m_ppfChannels[kM][niSample] * m_fCosGamma;
-        m_pfTempSample[kK] = pBFSrcDst->m_ppfChannels[kK][niSample];
-        m_pfTempSample[kL] = pBFSrcDst->m_ppfChannels[kL][niSample] * m_fCosGamma
-                            + pBFSrcDst->m_ppfChannels[kM][niSample] * m_fSinGamma;
-        m_pfTempSample[kN] = pBFSrcDst->m_ppfChannels[kN][niSample] * m_fCos2Gamma
-                            + pBFSrcDst->m_ppfChannels[kO][niSample] * m_fSin2Gamma;
-        m_pfTempSample[kP] = pBFSrcDst->m_ppfChannels[kP][niSample] * m_fCos3Gamma
-                            + pBFSrcDst->m_ppfChannels[kQ][niSample] * m_fSin3Gamma;
-
-        pBFSrcDst->m_ppfChannels[kQ][niSample] = m_pfTempSample[kQ];
-        pBFSrcDst->m_ppfChannels[kO][niSample] = m_pfTempSample[kO];
-        pBFSrcDst->m_ppfChannels[kM][niSample] = m_pfTempSample[kM];
-        pBFSrcDst->m_ppfChannels[kK][niSample] = m_pfTempSample[kK];
-        pBFSrcDst->m_ppfChannels[kL][niSample] = m_pfTempSample[kL];
-        pBFSrcDst->m_ppfChannels[kN][niSample] = m_pfTempSample[kN];
-        pBFSrcDst->m_ppfChannels[kP][niSample] = m_pfTempSample[kP];
+        for(unsigned j = 0; j < nBand; j++)
+            memcpy(&pfIn[j * knRotationChunk], &ppfChannels[nFirst + j][niStart], nChunk * sizeof(float));
+
+        for(unsigned i = 0; i < nBand; i++)
+        {
+            float* __restrict pfOut = &ppfChannels[nFirst + i][niStart];
+            memset(pfOut, 0, nChunk * sizeof(float));
+
+            for(unsigned j = 0; j < nBand; j++)
+            {
+                const float* __restrict pfInChannel = &pfIn[j * knRotationChunk];
+                float fGain = pfMatrix[i * nBand + j];
+                if(bRamp)
+                {
+                    // Linear ramp from the start matrix, reaching the target on the last sample of the ramp
+                    float fFrom = pfStart[i * nBand + j];
+                    if(fFrom == 0.f && fGain == 0.f)
+                        continue;
+                    float fStep = (fGain - fFrom) * fRampScale;
+                    float fGain0 = fFrom + fStep * (nRampPosition + 1);
+                    for(unsigned niSample = 0; niSample < nChunk; niSample++)
+                        pfOut[niSample] += (fGain0 + fStep * niSample) * pfInChannel[niSample];
+                }
+                else
+                {
+                    if(fGain == 0.f)
+                        continue;
+                    for(unsigned niSample = 0; niSample < nChunk; niSample++)
+                        pfOut[niSample] += fGain * pfInChannel[niSample];
+                }
+            }
+        }
     }
 }
 
@@ -414,41 +456,50 @@ void CAmbisonicProcessor::ProcessOrder3_2D(CBFormat* pBFSrcDst, unsigned nSample
 
 void CAmbisonicProcessor::ShelfFilterOrder(CBFormat* pBFSrcDst, unsigned nSamples)
 {
-    kiss_fft_cpx cpTemp;
-
     unsigned iChannelOrder = 0;
 
     // Filter the Ambisonics channels
     // All  channels are filtered using linear phase FIR filters.
     // In the case of the 0th order signal (W channel) this takes the form of a delay
     // For all other channels shelf filters are used
-    memset(m_pfScratchBufferA, 0, m_nFFTSize * sizeof(float));
+    memset(m_pfScratchBufferA.data(), 0, m_nFFTSize * sizeof(float));
     for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
     {
 
         iChannelOrder = int(sqrt(niChannel));    //get the order of the current channel
 
-        memcpy(m_pfScratchBufferA, pBFSrcDst->m_ppfChannels[niChannel], m_nBlockSize * sizeof(float));
+        memcpy(m_pfScratchBufferA.data(), pBFSrcDst->m_ppfChannels[niChannel], m_nBlockSize * sizeof(float));
         memset(&m_pfScratchBufferA[m_nBlockSize], 0, (m_nFFTSize - m_nBlockSize) * sizeof(float));
-        kiss_fftr(m_pFFT_psych_cfg, m_pfScratchBufferA, m_pcpScratch);
+        m_pFFT_psych->forward(m_pfScratchBufferA.data(), m_pcpScratch.get());
         // Perform the convolution in the frequency domain
-        for(unsigned ni = 0; ni < m_nFFTBins; ni++)
-        {
-            cpTemp.r = m_pcpScratch[ni].r * m_ppcpPsychFilters[iChannelOrder][ni].r
-                        - m_pcpScratch[ni].i * m_ppcpPsychFilters[iChannelOrder][ni].i;
-            cpTemp.i = m_pcpScratch[ni].r * m_ppcpPsychFilters[iChannelOrder][ni].i
-                        + m_pcpScratch[ni].i * m_ppcpPsychFilters[iChannelOrder][ni].r;
-            m_pcpScratch[ni] = cpTemp;
-        }
+        spectrumMultiply(m_pcpScratch.get(), m_ppcpPsychFilters[iChannelOrder].get(), m_pcpScratch.get(), m_nFFTBins);
         // Convert from frequency domain back to time domain
-        kiss_fftri(m_pIFFT_psych_cfg, m_pcpScratch, m_pfScratchBufferA);
+        m_pFFT_psych->inverse(m_pcpScratch.get(), m_pfScratchBufferA.data());
         for(unsigned ni = 0; ni < m_nFFTSize; ni++)
             m_pfScratchBufferA[ni] *= m_fFFTScaler;
-                memcpy(pBFSrcDst->m_ppfChannels[niChannel], m_pfScratchBufferA, m_nBlockSize * sizeof(float));
+                memcpy(pBFSrcDst->m_ppfChannels[niChannel], m_pfScratchBufferA.data(), m_nBlockSize * sizeof(float));
         for(unsigned ni = 0; ni < m_nOverlapLength; ni++)
                 {
                         pBFSrcDst->m_ppfChannels[niChannel][ni] += m_pfOverlap[niChannel][ni];
                 }
-                memcpy(m_pfOverlap[niChannel], &m_pfScratchBufferA[m_nBlockSize], m_nOverlapLength * sizeof(float));
+                memcpy(m_pfOverlap[niChannel].data(), &m_pfScratchBufferA[m_nBlockSize], m_nOverlapLength * sizeof(float));
+    }
+}
+
+void CAmbisonicProcessor::ShelfFilterOrderIIR(CBFormat* pBFSrcDst, unsigned nSamples)
+{
+    // Minimum phase shelf-filters: each channel goes through the biquad
+    // sections of its order, in place, followed by the gain of the order
+    for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    {
+        unsigned iChannelOrder = int(sqrt(niChannel));    //get the order of the current channel
+        float* pfChannel = pBFSrcDst->m_ppfChannels[niChannel];
+
+        for(unsigned niSection = 0; niSection < m_pnShelfSections[iChannelOrder]; niSection++)
+            m_ShelfIIR[niChannel * knMaxShelfSections + niSection].Process(pfChannel, pfChannel, nSamples);
+
+        float fGain = m_pfShelfGain[iChannelOrder];
+        for(unsigned ni = 0; ni < nSamples; ni++)
+            pfChannel[ni] *= fGain;
     }
 }
@@ -16,11 +16,6 @@
 
 #include "AmbisonicSource.h"
 
-#define fSqrt32 sqrt(3.f)/2.f
-#define fSqrt58 sqrt(5.f/8.f)
-#define fSqrt152 sqrt(15.f)/2.f
-#define fSqrt38 sqrt(3.f/8.f)
-
 CAmbisonicSource::CAmbisonicSource()
 {
     m_polPosition.fAzimuth = 0.f;
@@ -36,6 +31,8 @@ bool CAmbisonicSource::Configure(unsigned nOrder, bool b3D, unsigned nMisc)
         return false;
 
     m_pfCoeff.resize( m_nChannelCount, 0 );
+    m_pfNormalisation.resize( m_nChannelCount );
+    SphericalHarmonicNormalisation(m_nOrder, m_b3D, kSN3D, m_pfNormalisation.data());
     // for a Basic Ambisonics decoder all of the gains are set to 1.f
     m_pfOrderWeights.resize( m_nOrder + 1, 1.f );
 
@@ -49,73 +46,18 @@ void CAmbisonicSource::Reset()
 
 void CAmbisonicSource::Refresh()
 {
-    float fCosAzim = cosf(m_polPosition.fAzimuth);
-    float fSinAzim = sinf(m_polPosition.fAzimuth);
-    float fCosElev = cosf(m_polPosition.fElevation);
-    float fSinElev = sinf(m_polPosition.fElevation);
-
-    float fCos2Azim = cosf(2.f * m_polPosition.fAzimuth);
-    float fSin2Azim = sinf(2.f * m_polPosition.fAzimuth);
-    float fSin2Elev = sinf(2.f * m_polPosition.fElevation);
+    // Uses ACN channel ordering and SN3D normalization scheme (AmbiX format) for 3D
+    SphericalHarmonics(m_nOrder, m_b3D, m_polPosition.fAzimuth, m_polPosition.fElevation,
+                       m_pfNormalisation.data(), m_pfCoeff.data());
 
-    if(m_b3D)
-    {
-        // Uses ACN channel ordering and SN3D normalization scheme (AmbiX format)
-        if(m_nOrder >= 0)
-        {
-            m_pfCoeff[0] = 1.f * m_pfOrderWeights[0]; // W
-        }
-        if(m_nOrder >= 1)
-        {
-            m_pfCoeff[1] = (fSinAzim * fCosElev) * m_pfOrderWeights[1]; // Y
-            m_pfCoeff[2] = (fSinElev) * m_pfOrderWeights[1]; // Z
-            m_pfCoeff[3] = (fCosAzim * fCosElev) * m_pfOrderWeights[1]; // X
-        }
-        if(m_nOrder >= 2)
-        {
-            m_pfCoeff[4] = fSqrt32*(fSin2Azim * powf(fCosElev, 2)) * m_pfOrderWeights[2]; // V
-            m_pfCoeff[5] = fSqrt32*(fSinAzim * fSin2Elev) * m_pfOrderWeights[2]; // T
-            m_pfCoeff[6] = (1.5f * powf(fSinElev, 2.f) - 0.5f) * m_pfOrderWeights[2]; // R
-            m_pfCoeff[7] = fSqrt32*(fCosAzim * fSin2Elev) * m_pfOrderWeights[2]; // S
-            m_pfCoeff[8] = fSqrt32*(fCos2Azim * powf(fCosElev, 2)) * m_pfOrderWeights[2]; // U
-        }
-        if(m_nOrder >= 3)
-        {
-            m_pfCoeff[9] = fSqrt58*(sinf(3.f * m_polPosition.fAzimuth) * powf(fCosElev, 3.f)) * m_pfOrderWeights[3]; // Q
-            m_pfCoeff[10] = fSqrt152*(fSin2Azim * fSinElev * powf(fCosElev, 2.f)) * m_pfOrderWeights[3]; // O
-            m_pfCoeff[11] = fSqrt38*(fSinAzim * fCosElev * (5.f * powf(fSinElev, 2.f) - 1.f)) * m_pfOrderWeights[3]; // M
-            m_pfCoeff[12] = (fSinElev * (5.f * powf(fSinElev, 2.f) - 3.f) * 0.5f) * m_pfOrderWeights[3]; // K
-            m_pfCoeff[13] = fSqrt38*(fCosAzim * fCosElev * (5.f * powf(fSinElev, 2.f) - 1.f)) * m_pfOrderWeights[3]; // L
-            m_pfCoeff[14] = fSqrt152*(fCos2Azim * fSinElev * powf(fCosElev, 2.f)) * m_pfOrderWeights[3]; // N
-            m_pfCoeff[15] = fSqrt58*(cosf(3.f * m_polPosition.fAzimuth) * powf(fCosElev, 3.f)) * m_pfOrderWeights[3]; // P
-
-        }
-    }
-    else
+    for(unsigned niOrder = 0; niOrder <= m_nOrder; niOrder++)
     {
-        if(m_nOrder >= 0)
-        {
-            m_pfCoeff[0] = m_pfOrderWeights[0];
-        }
-        if(m_nOrder >= 1)
-        {
-            m_pfCoeff[1] = (fCosAzim * fCosElev) * m_pfOrderWeights[1];
-            m_pfCoeff[2] = (fSinAzim * fCosElev) * m_pfOrderWeights[1];
-        }
-        if(m_nOrder >= 2)
-        {
-            m_pfCoeff[3] = (fCos2Azim * powf(fCosElev, 2)) * m_pfOrderWeights[2];
-            m_pfCoeff[4] = (fSin2Azim * powf(fCosElev, 2)) * m_pfOrderWeights[2];
-        }
-        if(m_nOrder >= 3)
-        {
-            m_pfCoeff[5] = (cosf(3.f * m_polPosition.fAzimuth) * powf(fCosElev, 3.f)) * m_pfOrderWeights[3];
-            m_pfCoeff[6] = (sinf(3.f * m_polPosition.fAzimuth) * powf(fCosElev, 3.f)) * m_pfOrderWeights[3];
-        }
+        float fWeight = m_pfOrderWeights[niOrder] * m_fGain;
+        unsigned niStart = OrderToComponentPosition(niOrder, m_b3D);
+        unsigned niEnd = OrderToComponentPosition(niOrder + 1, m_b3D);
+        for(unsigned ni = niStart; ni < niEnd; ni++)
+            m_pfCoeff[ni] *= fWeight;
     }
-
-    for(unsigned ni = 0; ni < m_nChannelCount; ni++)
-        m_pfCoeff[ni] *= m_fGain;
 }
 
 void CAmbisonicSource::SetPosition(PolarPoint polPosition)
@@ -123,6 +65,20 @@ void CAmbisonicSource::SetPosition(PolarPoint polPosition)
     m_polPosition = polPosition;
 }
 
+void CAmbisonicSource::PostPosition(PolarPoint polPosition)
+{
+    m_PositionQueue.Push(polPosition);
+}
+
+bool CAmbisonicSource::ApplyPostedParameters()
+{
+    PolarPoint polPosition;
+    if(!m_PositionQueue.PopLatest(polPosition))
+        return false;
+    SetPosition(polPosition);
+    return true;
+}
+
 PolarPoint CAmbisonicSource::GetPosition()
 {
     return m_polPosition;
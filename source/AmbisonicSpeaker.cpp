@@ -41,6 +41,11 @@ void CAmbisonicSpeaker::Process(CBFormat* pBFSrc, unsigned nSamples, float* pfDs
 {
     unsigned niChannel = 0;
     unsigned niSample = 0;
+
+    //Parameters posted by a control thread
+    if(ApplyPostedParameters())
+        Refresh();
+
     memset(pfDst, 0, nSamples * sizeof(float));
     for(niChannel = 0; niChannel < m_nChannelCount; niChannel++)
     {
@@ -18,7 +18,6 @@
 
 #include <cstdlib>
 #include <cmath>
-#include <iostream>
 #include <algorithm>
 
 CAmbisonicZoomer::CAmbisonicZoomer()
@@ -51,6 +50,7 @@ bool CAmbisonicZoomer::Configure(unsigned nOrder, bool b3D, unsigned nMisc)
         a_m[iOrder] = (2*iOrder+1)*factorial(m_nOrder)*factorial(m_nOrder+1) / (factorial(m_nOrder+iOrder+1)*factorial(m_nOrder-iOrder));
 
     unsigned iDegree=0;
+    m_AmbFrontMic = 0.f;
     for(unsigned iChannel = 0; iChannel<m_nChannelCount; iChannel++)
     {
         m_AmbEncoderFront[iChannel] = m_AmbDecoderFront.GetCoefficient(0, iChannel);
@@ -85,8 +85,21 @@ float CAmbisonicZoomer::GetZoom()
     return m_fZoom;
 }
 
+void CAmbisonicZoomer::PostZoom(float fZoom)
+{
+    m_ZoomQueue.Push(fZoom);
+}
+
 void CAmbisonicZoomer::Process(CBFormat* pBFSrcDst, unsigned nSamples)
 {
+    //Zoom posted by a control thread
+    float fZoom;
+    if(m_ZoomQueue.PopLatest(fZoom))
+    {
+        SetZoom(fZoom);
+        Refresh();
+    }
+
     for(unsigned niSample = 0; niSample < nSamples; niSample++)
     {
         float fMic = 0.f;
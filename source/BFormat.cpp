@@ -13,22 +13,30 @@
 /*############################################################################*/
 
 
-#include <cassert>
 #include "BFormat.h"
 
+#include <cstring>
+
 CBFormat::CBFormat()
 {
     m_nSamples = 0;
+    m_nStride = 0;
+    m_nAlignment = kDefaultAlignment;
     m_nDataLength = 0;
 }
 
 CBFormat::CBFormat(const CBFormat& other)
 {
-    /// Set m_nSamples?
-    /// Set m_nDataLength?
+    m_nSamples = 0;
+    m_nStride = 0;
+    m_nAlignment = other.m_nAlignment;
+    m_nDataLength = 0;
 
-    assert(m_nDataLength <= other.m_nDataLength);
-    memcpy(m_pfData.data(), other.m_pfData.data(), m_nDataLength * sizeof(float));
+    if(other.m_ppfChannels)
+    {
+        Configure(other.m_nOrder, other.m_b3D, other.m_nSamples, other.m_nAlignment);
+        *this = other;
+    }
 }
 
 unsigned CBFormat::GetSampleCount()
@@ -36,22 +44,47 @@ unsigned CBFormat::GetSampleCount()
     return m_nSamples;
 }
 
+unsigned CBFormat::GetChannelStride()
+{
+    return m_nStride;
+}
+
+unsigned CBFormat::GetAlignment()
+{
+    return m_nAlignment;
+}
+
 bool CBFormat::Configure(unsigned nOrder, bool b3D, unsigned nSampleCount)
 {
+    return Configure(nOrder, b3D, nSampleCount, kDefaultAlignment);
+}
+
+bool CBFormat::Configure(unsigned nOrder, bool b3D, unsigned nSampleCount, unsigned nAlignment)
+{
+    if(nAlignment < sizeof(float) || (nAlignment & (nAlignment - 1)) != 0)
+        return false;
+
     bool success = CAmbisonicBase::Configure(nOrder, b3D, nSampleCount);
     if(!success)
         return false;
 
+    unsigned nAlignSamples = nAlignment / sizeof(float);
     m_nSamples = nSampleCount;
-    m_nDataLength = m_nSamples * m_nChannelCount;
-
-    m_pfData.resize(m_nDataLength);
-    memset(m_pfData.data(), 0, m_nDataLength * sizeof(float));
+    m_nAlignment = nAlignment;
+    m_nStride = (m_nSamples + nAlignSamples - 1) / nAlignSamples * nAlignSamples;
+    m_nDataLength = m_nStride * m_nChannelCount;
+
+    // Over-allocate so that the first channel can be moved up to the next
+    // aligned address, the stride keeps the following ones aligned
+    m_pfData.assign(m_nDataLength + nAlignSamples - 1, 0.f);
+    void* pvData = m_pfData.data();
+    size_t nSpace = m_pfData.size() * sizeof(float);
+    float* pfData = (float*)std::align(m_nAlignment, m_nDataLength * sizeof(float), pvData, nSpace);
     m_ppfChannels.reset(new float*[m_nChannelCount]);
 
     for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
     {
-        m_ppfChannels[niChannel] = &m_pfData[niChannel * m_nSamples];
+        m_ppfChannels[niChannel] = &pfData[niChannel * m_nStride];
     }
 
     return true;
@@ -59,7 +92,7 @@ bool CBFormat::Configure(unsigned nOrder, bool b3D, unsigned nSampleCount)
 
 void CBFormat::Reset()
 {
-    memset(m_pfData.data(), 0, m_nDataLength * sizeof(float));
+    memset(m_pfData.data(), 0, m_pfData.size() * sizeof(float));
 }
 
 void CBFormat::Refresh()
@@ -77,17 +110,48 @@ void CBFormat::ExtractStream(float* pfData, unsigned nChannel, unsigned nSamples
     memcpy(pfData, m_ppfChannels[nChannel], nSamples * sizeof(float));
 }
 
+void CBFormat::InsertInterleaved(const float* pfData, unsigned nFrameStride, unsigned nSamples)
+{
+    Deinterleave(pfData, nFrameStride, m_ppfChannels.get(), m_nChannelCount, nSamples);
+}
+
+void CBFormat::InsertInterleaved(const int16_t* psData, unsigned nFrameStride, unsigned nSamples)
+{
+    Deinterleave(psData, nFrameStride, m_ppfChannels.get(), m_nChannelCount, nSamples);
+}
+
+void CBFormat::InsertInterleaved(const int32_t* pnData, unsigned nFrameStride, unsigned nSamples)
+{
+    Deinterleave(pnData, nFrameStride, m_ppfChannels.get(), m_nChannelCount, nSamples);
+}
+
+void CBFormat::ExtractInterleaved(float* pfData, unsigned nFrameStride, unsigned nSamples)
+{
+    Interleave(m_ppfChannels.get(), m_nChannelCount, nSamples, pfData, nFrameStride);
+}
+
+void CBFormat::ExtractInterleaved(int16_t* psData, unsigned nFrameStride, unsigned nSamples, CDither* pDither)
+{
+    Interleave(m_ppfChannels.get(), m_nChannelCount, nSamples, psData, nFrameStride, pDither);
+}
+
+void CBFormat::ExtractInterleaved(int32_t* pnData, unsigned nFrameStride, unsigned nSamples, CDither* pDither)
+{
+    Interleave(m_ppfChannels.get(), m_nChannelCount, nSamples, pnData, nFrameStride, pDither);
+}
+
 CBFormat& CBFormat::operator = (const CBFormat &bf)
 {
     if (&bf != this) {
-        memcpy(m_pfData.data(), bf.m_pfData.data(), m_nDataLength * sizeof(float));
+        for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+            memcpy(m_ppfChannels[niChannel], bf.m_ppfChannels[niChannel], m_nSamples * sizeof(float));
     }
     return *this;
 }
 
 bool CBFormat::operator == (const CBFormat &bf)
 {
-    if(m_b3D == bf.m_b3D && m_nOrder == bf.m_nOrder && m_nDataLength == bf.m_nDataLength)
+    if(m_b3D == bf.m_b3D && m_nOrder == bf.m_nOrder && m_nSamples == bf.m_nSamples)
         return true;
     else
         return false;
@@ -95,7 +159,7 @@ bool CBFormat::operator == (const CBFormat &bf)
 
 bool CBFormat::operator != (const CBFormat &bf)
 {
-    if(m_b3D != bf.m_b3D || m_nOrder != bf.m_nOrder || m_nDataLength != bf.m_nDataLength)
+    if(m_b3D != bf.m_b3D || m_nOrder != bf.m_nOrder || m_nSamples != bf.m_nSamples)
         return true;
     else
         return false;
@@ -0,0 +1,76 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CBFormatView - Ambisonic BFormat View                                   #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      BFormatView.cpp                                          #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "BFormatView.h"
+
+#include <cstdint>
+#include <cstring>
+
+CBFormatView::CBFormatView()
+{
+    m_nAlignment = sizeof(float);
+}
+
+bool CBFormatView::Configure(unsigned nOrder, bool b3D, unsigned nSampleCount)
+{
+    bool success = CAmbisonicBase::Configure(nOrder, b3D, nSampleCount);
+    if(!success)
+        return false;
+
+    m_nSamples = nSampleCount;
+    m_nStride = 0;
+    m_nAlignment = sizeof(float);
+    m_nDataLength = 0;
+
+    m_pfData.clear();
+    m_pfData.shrink_to_fit();
+    m_ppfChannels.reset(new float*[m_nChannelCount]());
+
+    return true;
+}
+
+void CBFormatView::Reset()
+{
+    for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    {
+        if(m_ppfChannels[niChannel])
+            memset(m_ppfChannels[niChannel], 0, m_nSamples * sizeof(float));
+    }
+}
+
+void CBFormatView::SetChannels(float* const* ppfChannels)
+{
+    uintptr_t nAddresses = kDefaultAlignment;
+    for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+    {
+        m_ppfChannels[niChannel] = ppfChannels[niChannel];
+        nAddresses |= (uintptr_t)ppfChannels[niChannel];
+    }
+    // Lowest set bit of all the addresses together
+    m_nAlignment = (unsigned)(nAddresses & (~nAddresses + 1));
+    m_nStride = 0;
+}
+
+void CBFormatView::SetChannels(float* pfData, unsigned nChannelStride)
+{
+    for(unsigned niChannel = 0; niChannel < m_nChannelCount; niChannel++)
+        m_ppfChannels[niChannel] = &pfData[niChannel * nChannelStride];
+
+    uintptr_t nAddresses = kDefaultAlignment | (uintptr_t)pfData;
+    if(m_nChannelCount > 1)
+        nAddresses |= nChannelStride * sizeof(float);
+    m_nAlignment = (unsigned)(nAddresses & (~nAddresses + 1));
+    m_nStride = nChannelStride;
+}
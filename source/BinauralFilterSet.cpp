@@ -0,0 +1,103 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CBinauralFilterSet - Shared Binaural Filters                            #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      BinauralFilterSet.cpp                                    #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "BinauralFilterSet.h"
+
+
+CBinauralFilterSet::CBinauralFilterSet(unsigned nTaps, unsigned nFFTSize, unsigned nPartitions, unsigned nChannels)
+{
+    m_nTaps = nTaps;
+    m_nFFTSize = nFFTSize;
+    m_nPartitions = nPartitions;
+    m_nChannels = nChannels;
+    m_nFilterSize = nPartitions * (nFFTSize / 2 + 1);
+    m_pcpFilters.reset(new kiss_fft_cpx[2 * m_nChannels * m_nFilterSize]());
+}
+
+kiss_fft_cpx* CBinauralFilterSet::GetFilter(unsigned nEar, unsigned nChannel)
+{
+    return &m_pcpFilters[(nEar * m_nChannels + nChannel) * m_nFilterSize];
+}
+
+const kiss_fft_cpx* CBinauralFilterSet::GetFilter(unsigned nEar, unsigned nChannel) const
+{
+    return &m_pcpFilters[(nEar * m_nChannels + nChannel) * m_nFilterSize];
+}
+
+unsigned CBinauralFilterSet::GetFilterSize() const
+{
+    return m_nFilterSize;
+}
+
+unsigned CBinauralFilterSet::GetTaps() const
+{
+    return m_nTaps;
+}
+
+unsigned CBinauralFilterSet::GetFFTSize() const
+{
+    return m_nFFTSize;
+}
+
+unsigned CBinauralFilterSet::GetPartitions() const
+{
+    return m_nPartitions;
+}
+
+unsigned CBinauralFilterSet::GetChannelCount() const
+{
+    return m_nChannels;
+}
+
+
+CBinauralFilterRegistry& CBinauralFilterRegistry::GetInstance()
+{
+    static CBinauralFilterRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<const CBinauralFilterSet> CBinauralFilterRegistry::Find(const std::string& sKey)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_filterSets.find(sKey);
+    if(it == m_filterSets.end())
+        return nullptr;
+    std::shared_ptr<const CBinauralFilterSet> pFilters = it->second.lock();
+    if(!pFilters)
+        m_filterSets.erase(it);
+    return pFilters;
+}
+
+std::shared_ptr<const CBinauralFilterSet> CBinauralFilterRegistry::Insert(const std::string& sKey,
+                                                                          std::shared_ptr<const CBinauralFilterSet> pFilters)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Drop the entries of the sets nobody uses any more
+    for(auto it = m_filterSets.begin(); it != m_filterSets.end();)
+    {
+        if(it->second.expired())
+            it = m_filterSets.erase(it);
+        else
+            ++it;
+    }
+
+    std::weak_ptr<const CBinauralFilterSet>& entry = m_filterSets[sKey];
+    std::shared_ptr<const CBinauralFilterSet> pExisting = entry.lock();
+    if(pExisting)
+        return pExisting;
+    entry = pFilters;
+    return pFilters;
+}
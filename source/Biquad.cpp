@@ -0,0 +1,88 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CBiquad - Second Order IIR Filter                                       #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      Biquad.cpp                                               #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "Biquad.h"
+#include "AmbisonicCommons.h"
+
+
+CBiquad::CBiquad()
+{
+    SetCoefficients(1.f, 0.f, 0.f, 0.f, 0.f);
+    Reset();
+}
+
+void CBiquad::SetCoefficients(float fB0, float fB1, float fB2, float fA1, float fA2)
+{
+    m_fB0 = fB0;
+    m_fB1 = fB1;
+    m_fB2 = fB2;
+    m_fA1 = fA1;
+    m_fA2 = fA2;
+}
+
+void CBiquad::SetLowPass(float fFrequency, float fSampleRate)
+{
+    // Bilinear transform with prewarping, Q = 1/sqrt(2)
+    double dK = tan(M_PI * fFrequency / fSampleRate);
+    double dNorm = 1. / (1. + sqrt(2.) * dK + dK * dK);
+    double dB0 = dK * dK * dNorm;
+    SetCoefficients((float)dB0, (float)(2. * dB0), (float)dB0,
+                    (float)(2. * (dK * dK - 1.) * dNorm), (float)((1. - sqrt(2.) * dK + dK * dK) * dNorm));
+}
+
+void CBiquad::SetHighPass(float fFrequency, float fSampleRate)
+{
+    double dK = tan(M_PI * fFrequency / fSampleRate);
+    double dNorm = 1. / (1. + sqrt(2.) * dK + dK * dK);
+    SetCoefficients((float)dNorm, (float)(-2. * dNorm), (float)dNorm,
+                    (float)(2. * (dK * dK - 1.) * dNorm), (float)((1. - sqrt(2.) * dK + dK * dK) * dNorm));
+}
+
+void CBiquad::SetHighShelf(float fFrequency, float fSampleRate, float fGain, float fQ)
+{
+    double dA = sqrt((double)fGain);
+    double dW = 2. * M_PI * fFrequency / fSampleRate;
+    double dCos = cos(dW);
+    double dAlpha = 2. * sqrt(dA) * sin(dW) / (2. * fQ);
+    double dNorm = 1. / ((dA + 1.) - (dA - 1.) * dCos + dAlpha);
+    SetCoefficients((float)(dA * ((dA + 1.) + (dA - 1.) * dCos + dAlpha) * dNorm),
+                    (float)(-2. * dA * ((dA - 1.) + (dA + 1.) * dCos) * dNorm),
+                    (float)(dA * ((dA + 1.) + (dA - 1.) * dCos - dAlpha) * dNorm),
+                    (float)(2. * ((dA - 1.) - (dA + 1.) * dCos) * dNorm),
+                    (float)(((dA + 1.) - (dA - 1.) * dCos - dAlpha) * dNorm));
+}
+
+void CBiquad::Reset()
+{
+    m_fZ1 = 0.f;
+    m_fZ2 = 0.f;
+}
+
+void CBiquad::Process(const float* pfSrc, float* pfDst, unsigned nSamples)
+{
+    float fZ1 = m_fZ1;
+    float fZ2 = m_fZ2;
+    for(unsigned niSample = 0; niSample < nSamples; niSample++)
+    {
+        float fIn = pfSrc[niSample];
+        float fOut = m_fB0 * fIn + fZ1;
+        fZ1 = m_fB1 * fIn - m_fA1 * fOut + fZ2;
+        fZ2 = m_fB2 * fIn - m_fA2 * fOut;
+        pfDst[niSample] = fOut;
+    }
+    // Flush the decaying state to zero rather than running on denormals
+    m_fZ1 = fabsf(fZ1) < 1e-20f ? 0.f : fZ1;
+    m_fZ2 = fabsf(fZ2) < 1e-20f ? 0.f : fZ2;
+}
@@ -0,0 +1,292 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  CFilterCache - Binaural Filter Cache                                    #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      FilterCache.cpp                                          #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "FilterCache.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#else
+# include <process.h>
+# define getpid _getpid
+#endif
+
+namespace {
+    /** Change when the file layout or the way the filters are computed changes */
+    const uint32_t knFilterCacheVersion = 1;
+    const char kpcFilterCacheMagic[8] = {'S', 'P', 'A', 'F', 'L', 'T', 'C', 0};
+    const size_t knFilterCacheAlignment = 64;
+
+    struct FilterCacheHeader
+    {
+        char pcMagic[8];
+        uint32_t nVersion;
+        uint32_t nKeyLength;
+        uint32_t nTaps;
+        uint32_t nFFTSize;
+        uint32_t nPartitions;
+        uint32_t nChannels;
+        uint64_t nDataOffset;
+        uint64_t nDataSize;
+        uint64_t nChecksum;
+    };
+
+    /** FNV-1a, run on 32 bit words for speed */
+    uint64_t Checksum(const unsigned char* pData, size_t nSize, uint64_t nHash = 14695981039346656037ull)
+    {
+        size_t ni = 0;
+        for(; ni + 4 <= nSize; ni += 4)
+        {
+            uint32_t nWord;
+            memcpy(&nWord, &pData[ni], 4);
+            nHash = (nHash ^ nWord) * 1099511628211ull;
+        }
+        for(; ni < nSize; ni++)
+            nHash = (nHash ^ pData[ni]) * 1099511628211ull;
+        return nHash;
+    }
+
+    /** Numbers the temporary files written by this process */
+    std::atomic<unsigned> nTempFileCount(0);
+
+    size_t FilterSize(unsigned nFFTSize, unsigned nPartitions)
+    {
+        return (size_t)nPartitions * (nFFTSize / 2 + 1);
+    }
+}
+
+CFilterCache::CFilterCache()
+{
+    m_pData = nullptr;
+    m_nDataSize = 0;
+    m_bMapped = false;
+    m_nTaps = 0;
+    m_nFFTSize = 0;
+    m_nPartitions = 0;
+    m_nChannels = 0;
+    m_pcpFilters = nullptr;
+}
+
+CFilterCache::~CFilterCache()
+{
+    Close();
+}
+
+void CFilterCache::SetDirectory(const std::string& sDirectory)
+{
+    m_sDirectory = sDirectory;
+}
+
+std::string CFilterCache::GetDirectory()
+{
+    return m_sDirectory;
+}
+
+bool CFilterCache::IsEnabled()
+{
+    return !m_sDirectory.empty();
+}
+
+std::string CFilterCache::GetPath(const std::string& sKey)
+{
+    char pcName[32];
+    snprintf(pcName, sizeof(pcName), "%016llx.filters",
+             (unsigned long long)Checksum((const unsigned char*)sKey.data(), sKey.size()));
+    std::string sPath = m_sDirectory;
+    if(sPath.back() != '/' && sPath.back() != '\\')
+        sPath += '/';
+    return sPath + pcName;
+}
+
+bool CFilterCache::Open(const std::string& sKey)
+{
+    Close();
+    if(!IsEnabled())
+        return false;
+
+    std::string sPath = GetPath(sKey);
+#ifndef _WIN32
+    int fd = open(sPath.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) == 0 && fileStat.st_size >= (off_t)sizeof(FilterCacheHeader))
+    {
+        void* pMapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(pMapping != MAP_FAILED)
+        {
+            m_pData = (const unsigned char*)pMapping;
+            m_nDataSize = fileStat.st_size;
+            m_bMapped = true;
+        }
+    }
+    close(fd);
+#else
+    FILE* pFile = fopen(sPath.c_str(), "rb");
+    if(!pFile)
+        return false;
+    unsigned char pcChunk[65536];
+    size_t nRead;
+    while((nRead = fread(pcChunk, 1, sizeof(pcChunk), pFile)) > 0)
+        m_pBuffer.insert(m_pBuffer.end(), pcChunk, pcChunk + nRead);
+    fclose(pFile);
+    m_pData = m_pBuffer.data();
+    m_nDataSize = m_pBuffer.size();
+#endif
+    if(!m_pData || m_nDataSize < sizeof(FilterCacheHeader))
+    {
+        Close();
+        return false;
+    }
+
+    // Check that the file is complete, from this version and for this key
+    FilterCacheHeader header;
+    memcpy(&header, m_pData, sizeof(header));
+    size_t nExpectedSize = 2 * (size_t)header.nChannels * FilterSize(header.nFFTSize, header.nPartitions) * sizeof(kiss_fft_cpx);
+    bool bValid = memcmp(header.pcMagic, kpcFilterCacheMagic, sizeof(kpcFilterCacheMagic)) == 0
+        && header.nVersion == knFilterCacheVersion
+        && header.nKeyLength == sKey.size()
+        && sizeof(header) + header.nKeyLength <= header.nDataOffset
+        && header.nDataOffset % knFilterCacheAlignment == 0
+        && header.nDataSize == nExpectedSize
+        && header.nDataOffset + header.nDataSize == m_nDataSize
+        && memcmp(&m_pData[sizeof(header)], sKey.data(), sKey.size()) == 0;
+    if(bValid)
+    {
+        uint64_t nChecksum = Checksum(&m_pData[sizeof(header)], header.nKeyLength);
+        nChecksum = Checksum(&m_pData[header.nDataOffset], header.nDataSize, nChecksum);
+        bValid = nChecksum == header.nChecksum;
+    }
+    if(!bValid)
+    {
+        Close();
+        return false;
+    }
+
+    m_nTaps = header.nTaps;
+    m_nFFTSize = header.nFFTSize;
+    m_nPartitions = header.nPartitions;
+    m_nChannels = header.nChannels;
+    m_pcpFilters = (const kiss_fft_cpx*)&m_pData[header.nDataOffset];
+
+    return true;
+}
+
+void CFilterCache::Close()
+{
+#ifndef _WIN32
+    if(m_bMapped)
+        munmap((void*)m_pData, m_nDataSize);
+#endif
+    m_bMapped = false;
+    m_pData = nullptr;
+    m_nDataSize = 0;
+    m_pBuffer.clear();
+    m_pBuffer.shrink_to_fit();
+    m_pcpFilters = nullptr;
+    m_nTaps = 0;
+    m_nFFTSize = 0;
+    m_nPartitions = 0;
+    m_nChannels = 0;
+}
+
+unsigned CFilterCache::GetTaps()
+{
+    return m_nTaps;
+}
+
+unsigned CFilterCache::GetFFTSize()
+{
+    return m_nFFTSize;
+}
+
+unsigned CFilterCache::GetPartitions()
+{
+    return m_nPartitions;
+}
+
+unsigned CFilterCache::GetChannelCount()
+{
+    return m_nChannels;
+}
+
+const kiss_fft_cpx* CFilterCache::GetFilter(unsigned nEar, unsigned nChannel)
+{
+    return &m_pcpFilters[(nEar * m_nChannels + nChannel) * FilterSize(m_nFFTSize, m_nPartitions)];
+}
+
+bool CFilterCache::Store(const std::string& sKey, const CBinauralFilterSet& filters)
+{
+    if(!IsEnabled())
+        return false;
+
+    unsigned nChannels = filters.GetChannelCount();
+    size_t nFilterBytes = filters.GetFilterSize() * sizeof(kiss_fft_cpx);
+
+    FilterCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.pcMagic, kpcFilterCacheMagic, sizeof(kpcFilterCacheMagic));
+    header.nVersion = knFilterCacheVersion;
+    header.nKeyLength = (uint32_t)sKey.size();
+    header.nTaps = filters.GetTaps();
+    header.nFFTSize = filters.GetFFTSize();
+    header.nPartitions = filters.GetPartitions();
+    header.nChannels = nChannels;
+    header.nDataOffset = (sizeof(header) + sKey.size() + knFilterCacheAlignment - 1) / knFilterCacheAlignment * knFilterCacheAlignment;
+    header.nDataSize = 2 * nChannels * nFilterBytes;
+    header.nChecksum = Checksum((const unsigned char*)sKey.data(), sKey.size());
+    for(unsigned niEar = 0; niEar < 2; niEar++)
+        for(unsigned niChannel = 0; niChannel < nChannels; niChannel++)
+            header.nChecksum = Checksum((const unsigned char*)filters.GetFilter(niEar, niChannel), nFilterBytes, header.nChecksum);
+
+    // Write to a file of our own and rename it over the entry once complete.
+    // The process id keeps apart the writers sharing the directory, the count
+    // the ones within this process.
+    std::string sPath = GetPath(sKey);
+    char pcSuffix[48];
+    snprintf(pcSuffix, sizeof(pcSuffix), ".%ld.%u.tmp", (long)getpid(), nTempFileCount++);
+    std::string sTempPath = sPath + pcSuffix;
+
+    FILE* pFile = fopen(sTempPath.c_str(), "wb");
+    if(!pFile)
+        return false;
+    const char pcPadding[knFilterCacheAlignment] = {0};
+    bool bSuccess = fwrite(&header, sizeof(header), 1, pFile) == 1
+        && fwrite(sKey.data(), 1, sKey.size(), pFile) == sKey.size()
+        && fwrite(pcPadding, 1, header.nDataOffset - sizeof(header) - sKey.size(), pFile) == header.nDataOffset - sizeof(header) - sKey.size();
+    for(unsigned niEar = 0; bSuccess && niEar < 2; niEar++)
+        for(unsigned niChannel = 0; bSuccess && niChannel < nChannels; niChannel++)
+            bSuccess = fwrite(filters.GetFilter(niEar, niChannel), 1, nFilterBytes, pFile) == nFilterBytes;
+    bSuccess = fclose(pFile) == 0 && bSuccess;
+
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    if(bSuccess)
+        remove(sPath.c_str());
+#endif
+    if(bSuccess)
+        bSuccess = rename(sTempPath.c_str(), sPath.c_str()) == 0;
+    if(!bSuccess)
+        remove(sTempPath.c_str());
+
+    return bSuccess;
+}
@@ -0,0 +1,292 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  Interleaving and Sample Format Conversion                               #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      SampleConversion.cpp                                     #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "SampleConversion.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+# define SAMPLE_CONVERSION_SSE2 1
+# include <emmintrin.h>
+# include <xmmintrin.h>
+#endif
+
+namespace {
+    const float kfInt16Scale = 32768.f;
+    const float kfInt32Scale = 2147483648.f;
+    // Largest float below 2^31, which itself does not fit in an int32_t
+    const float kfInt32Max = 2147483520.f;
+
+    // Conversion of one sample. The SSE2 versions below do the same
+    // operations in the same order, so both give the same results.
+    inline float toFloat(float fSample)
+    {
+        return fSample;
+    }
+
+    inline float toFloat(int16_t sSample)
+    {
+        return (float)sSample * (1.f / kfInt16Scale);
+    }
+
+    inline float toFloat(int32_t nSample)
+    {
+        return (float)nSample * (1.f / kfInt32Scale);
+    }
+
+    inline void fromFloat(float fSample, float* pfDst)
+    {
+        *pfDst = fSample;
+    }
+
+    inline void fromFloat(float fSample, int16_t* psDst)
+    {
+        fSample = std::min(std::max(fSample * kfInt16Scale, -kfInt16Scale), kfInt16Scale - 1.f);
+        *psDst = (int16_t)lrintf(fSample);
+    }
+
+    inline void fromFloat(float fSample, int32_t* pnDst)
+    {
+        fSample = std::min(std::max(fSample * kfInt32Scale, -kfInt32Scale), kfInt32Max);
+        *pnDst = (int32_t)lrintf(fSample);
+    }
+
+#if defined(SAMPLE_CONVERSION_SSE2)
+    // Conversion of four consecutive samples
+    inline __m128 load4(const float* pfSrc)
+    {
+        return _mm_loadu_ps(pfSrc);
+    }
+
+    inline __m128 load4(const int16_t* psSrc)
+    {
+        // Duplicate each sample into both halves of a 32-bit lane and shift
+        // the upper copy down to sign extend it
+        __m128i sSamples = _mm_loadl_epi64((const __m128i*)psSrc);
+        __m128i nSamples = _mm_srai_epi32(_mm_unpacklo_epi16(sSamples, sSamples), 16);
+        return _mm_mul_ps(_mm_cvtepi32_ps(nSamples), _mm_set1_ps(1.f / kfInt16Scale));
+    }
+
+    inline __m128 load4(const int32_t* pnSrc)
+    {
+        __m128i nSamples = _mm_loadu_si128((const __m128i*)pnSrc);
+        return _mm_mul_ps(_mm_cvtepi32_ps(nSamples), _mm_set1_ps(1.f / kfInt32Scale));
+    }
+
+    inline void store4(__m128 fSamples, float* pfDst)
+    {
+        _mm_storeu_ps(pfDst, fSamples);
+    }
+
+    inline void store4(__m128 fSamples, int16_t* psDst)
+    {
+        fSamples = _mm_mul_ps(fSamples, _mm_set1_ps(kfInt16Scale));
+        fSamples = _mm_min_ps(_mm_max_ps(fSamples, _mm_set1_ps(-kfInt16Scale)), _mm_set1_ps(kfInt16Scale - 1.f));
+        __m128i nSamples = _mm_cvtps_epi32(fSamples);
+        _mm_storel_epi64((__m128i*)psDst, _mm_packs_epi32(nSamples, nSamples));
+    }
+
+    inline void store4(__m128 fSamples, int32_t* pnDst)
+    {
+        fSamples = _mm_mul_ps(fSamples, _mm_set1_ps(kfInt32Scale));
+        fSamples = _mm_min_ps(_mm_max_ps(fSamples, _mm_set1_ps(-kfInt32Scale)), _mm_set1_ps(kfInt32Max));
+        _mm_storeu_si128((__m128i*)pnDst, _mm_cvtps_epi32(fSamples));
+    }
+#endif
+
+    template<typename T>
+    void deinterleave(const T* pSrc, unsigned nFrameStride, float* const* ppfDst, unsigned nChannels, unsigned nSamples)
+    {
+        unsigned niSample = 0;
+#if defined(SAMPLE_CONVERSION_SSE2)
+        // Blocks of four frames by four channels, converted and transposed in
+        // registers
+        for(; niSample + 4 <= nSamples; niSample += 4)
+        {
+            const T* pFrames = &pSrc[niSample * nFrameStride];
+            unsigned niChannel = 0;
+            for(; niChannel + 4 <= nChannels; niChannel += 4)
+            {
+                __m128 f0 = load4(&pFrames[niChannel]);
+                __m128 f1 = load4(&pFrames[nFrameStride + niChannel]);
+                __m128 f2 = load4(&pFrames[2 * nFrameStride + niChannel]);
+                __m128 f3 = load4(&pFrames[3 * nFrameStride + niChannel]);
+                _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+                _mm_storeu_ps(&ppfDst[niChannel][niSample], f0);
+                _mm_storeu_ps(&ppfDst[niChannel + 1][niSample], f1);
+                _mm_storeu_ps(&ppfDst[niChannel + 2][niSample], f2);
+                _mm_storeu_ps(&ppfDst[niChannel + 3][niSample], f3);
+            }
+            for(; niChannel < nChannels; niChannel++)
+                for(unsigned niFrame = 0; niFrame < 4; niFrame++)
+                    ppfDst[niChannel][niSample + niFrame] = toFloat(pFrames[niFrame * nFrameStride + niChannel]);
+        }
+#endif
+        for(; niSample < nSamples; niSample++)
+        {
+            const T* pFrame = &pSrc[niSample * nFrameStride];
+            for(unsigned niChannel = 0; niChannel < nChannels; niChannel++)
+                ppfDst[niChannel][niSample] = toFloat(pFrame[niChannel]);
+        }
+    }
+
+    // Channels niFirst to nChannels of a single frame
+    template<typename T>
+    void interleaveFrame(const float* const* ppfSrc, unsigned niFirst, unsigned nChannels, unsigned niSample, T* pFrame, CDither* pDither)
+    {
+        float afNoise[16];
+        for(unsigned niChannel = niFirst; niChannel < nChannels; niChannel++)
+        {
+            unsigned niNoise = (niChannel - niFirst) % 16;
+            float fSample = ppfSrc[niChannel][niSample];
+            if(pDither)
+            {
+                if(niNoise == 0)
+                    pDither->Generate(afNoise, std::min(16u, nChannels - niChannel));
+                fSample += afNoise[niNoise];
+            }
+            fromFloat(fSample, &pFrame[niChannel]);
+        }
+    }
+
+    template<typename T>
+    void interleave(const float* const* ppfSrc, unsigned nChannels, unsigned nSamples, T* pDst, unsigned nFrameStride, CDither* pDither)
+    {
+        unsigned niSample = 0;
+#if defined(SAMPLE_CONVERSION_SSE2)
+        float afNoise[16];
+        for(; niSample + 4 <= nSamples; niSample += 4)
+        {
+            T* pFrames = &pDst[niSample * nFrameStride];
+            unsigned niChannel = 0;
+            for(; niChannel + 4 <= nChannels; niChannel += 4)
+            {
+                __m128 f0 = _mm_loadu_ps(&ppfSrc[niChannel][niSample]);
+                __m128 f1 = _mm_loadu_ps(&ppfSrc[niChannel + 1][niSample]);
+                __m128 f2 = _mm_loadu_ps(&ppfSrc[niChannel + 2][niSample]);
+                __m128 f3 = _mm_loadu_ps(&ppfSrc[niChannel + 3][niSample]);
+                _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+                if(pDither)
+                {
+                    pDither->Generate(afNoise, 16);
+                    f0 = _mm_add_ps(f0, _mm_loadu_ps(&afNoise[0]));
+                    f1 = _mm_add_ps(f1, _mm_loadu_ps(&afNoise[4]));
+                    f2 = _mm_add_ps(f2, _mm_loadu_ps(&afNoise[8]));
+                    f3 = _mm_add_ps(f3, _mm_loadu_ps(&afNoise[12]));
+                }
+                store4(f0, &pFrames[niChannel]);
+                store4(f1, &pFrames[nFrameStride + niChannel]);
+                store4(f2, &pFrames[2 * nFrameStride + niChannel]);
+                store4(f3, &pFrames[3 * nFrameStride + niChannel]);
+            }
+            if(niChannel < nChannels)
+                for(unsigned niFrame = 0; niFrame < 4; niFrame++)
+                    interleaveFrame(ppfSrc, niChannel, nChannels, niSample + niFrame, &pFrames[niFrame * nFrameStride], pDither);
+        }
+#endif
+        for(; niSample < nSamples; niSample++)
+            interleaveFrame(ppfSrc, 0, nChannels, niSample, &pDst[niSample * nFrameStride], pDither);
+    }
+}
+
+CDither::CDither(unsigned nBits, unsigned nSeed)
+{
+    m_fLSB = ldexpf(1.f, 1 - (int)nBits);
+    for(unsigned niState = 0; niState < 16; niState++)
+    {
+        // Spread the seed over the generators, none may start at zero
+        uint32_t nState = (uint32_t)(nSeed * 16 + niState) * 2654435761u;
+        nState ^= nState >> 16;
+        m_nState[niState] = nState ? nState : 0x9e3779b9u;
+    }
+}
+
+void CDither::Generate(float* pfNoise, unsigned nSamples)
+{
+    // Sixteen xorshift generators side by side, as four independent chains of
+    // four lanes so that they do not wait for each other. The difference of
+    // the two 16-bit halves of a draw has the triangular distribution.
+    const float fScale = m_fLSB / 65536.f;
+    unsigned niSample = 0;
+#if defined(SAMPLE_CONVERSION_SSE2)
+    __m128i nState[4];
+    for(unsigned niChain = 0; niChain < 4; niChain++)
+        nState[niChain] = _mm_loadu_si128((const __m128i*)&m_nState[4 * niChain]);
+    for(; niSample + 16 <= nSamples; niSample += 16)
+    {
+        for(unsigned niChain = 0; niChain < 4; niChain++)
+        {
+            __m128i nDraw = nState[niChain];
+            nDraw = _mm_xor_si128(nDraw, _mm_slli_epi32(nDraw, 13));
+            nDraw = _mm_xor_si128(nDraw, _mm_srli_epi32(nDraw, 17));
+            nDraw = _mm_xor_si128(nDraw, _mm_slli_epi32(nDraw, 5));
+            nState[niChain] = nDraw;
+            __m128i nHigh = _mm_srli_epi32(nDraw, 16);
+            __m128i nLow = _mm_and_si128(nDraw, _mm_set1_epi32(0xffff));
+            __m128 fNoise = _mm_cvtepi32_ps(_mm_sub_epi32(nHigh, nLow));
+            _mm_storeu_ps(&pfNoise[niSample + 4 * niChain], _mm_mul_ps(fNoise, _mm_set1_ps(fScale)));
+        }
+    }
+    for(unsigned niChain = 0; niChain < 4; niChain++)
+        _mm_storeu_si128((__m128i*)&m_nState[4 * niChain], nState[niChain]);
+#endif
+    for(; niSample < nSamples; niSample += 16)
+    {
+        float afNoise[16];
+        for(unsigned niState = 0; niState < 16; niState++)
+        {
+            uint32_t nDraw = m_nState[niState];
+            nDraw ^= nDraw << 13;
+            nDraw ^= nDraw >> 17;
+            nDraw ^= nDraw << 5;
+            m_nState[niState] = nDraw;
+            afNoise[niState] = (float)((int32_t)(nDraw >> 16) - (int32_t)(nDraw & 0xffff)) * fScale;
+        }
+        unsigned nCount = std::min(16u, nSamples - niSample);
+        for(unsigned niNoise = 0; niNoise < nCount; niNoise++)
+            pfNoise[niSample + niNoise] = afNoise[niNoise];
+    }
+}
+
+void Deinterleave(const float* pfSrc, unsigned nFrameStride, float* const* ppfDst, unsigned nChannels, unsigned nSamples)
+{
+    deinterleave(pfSrc, nFrameStride, ppfDst, nChannels, nSamples);
+}
+
+void Deinterleave(const int16_t* psSrc, unsigned nFrameStride, float* const* ppfDst, unsigned nChannels, unsigned nSamples)
+{
+    deinterleave(psSrc, nFrameStride, ppfDst, nChannels, nSamples);
+}
+
+void Deinterleave(const int32_t* pnSrc, unsigned nFrameStride, float* const* ppfDst, unsigned nChannels, unsigned nSamples)
+{
+    deinterleave(pnSrc, nFrameStride, ppfDst, nChannels, nSamples);
+}
+
+void Interleave(const float* const* ppfSrc, unsigned nChannels, unsigned nSamples, float* pfDst, unsigned nFrameStride)
+{
+    interleave(ppfSrc, nChannels, nSamples, pfDst, nFrameStride, nullptr);
+}
+
+void Interleave(const float* const* ppfSrc, unsigned nChannels, unsigned nSamples, int16_t* psDst, unsigned nFrameStride, CDither* pDither)
+{
+    interleave(ppfSrc, nChannels, nSamples, psDst, nFrameStride, pDither);
+}
+
+void Interleave(const float* const* ppfSrc, unsigned nChannels, unsigned nSamples, int32_t* pnDst, unsigned nFrameStride, CDither* pDither)
+{
+    interleave(ppfSrc, nChannels, nSamples, pnDst, nFrameStride, pDither);
+}
@@ -15,6 +15,8 @@
 
 #include "SpeakersBinauralizer.h"
 
+#include <cstdio>
+
 
 SpeakersBinauralizer::SpeakersBinauralizer()
     : m_nSpeakers(0)
@@ -32,28 +34,38 @@ bool SpeakersBinauralizer::Configure(unsigned nSampleRate,
         unsigned niEar = 0;
         unsigned niTap = 0;
 
+        m_nBlockSize = nBlockSize;
+
+        //Each speaker feed is an input channel of the convolution
+        m_nSpeakers = nSpeakers;
+        m_nChannelCount = nSpeakers;
+
+        //Use the filters of another binauralizer or of the cache if this configuration was seen before
+        std::string sFilterKey = GetHRTFKey(nSampleRate, HRTFPath);
+        if(!sFilterKey.empty())
+        {
+            sFilterKey = "speakers " + sFilterKey + " block=" + std::to_string(m_nBlockSize);
+            for(unsigned niChannel = 0; niChannel < nSpeakers; niChannel++)
+            {
+                PolarPoint position = speakers[niChannel].GetPosition();
+                char pcPosition[64];
+                snprintf(pcPosition, sizeof(pcPosition), " %.9g,%.9g", position.fAzimuth, position.fElevation);
+                sFilterKey += pcPosition;
+            }
+        }
+        if(FindFilters(sFilterKey, tailLength))
+            return true;
+
         HRTF *p_hrtf = getHRTF(nSampleRate, HRTFPath);
         if (p_hrtf == nullptr)
             return false;
 
         m_nTaps = tailLength = p_hrtf->getHRTFLen();
-        m_nBlockSize = nBlockSize;
-
-        //What will the overlap size be?
-        m_nOverlapLength = m_nBlockSize < m_nTaps ? m_nBlockSize - 1 : m_nTaps - 1;
-        //How large does the FFT need to be
-        m_nFFTSize = 1;
-        while(m_nFFTSize < (m_nBlockSize + m_nTaps + m_nOverlapLength))
-                m_nFFTSize <<= 1;
-        //How many bins is that
-        m_nFFTBins = m_nFFTSize / 2 + 1;
-        //What do we need to scale the result of the iFFT by
-        m_fFFTScaler = 1.f / m_nFFTSize;
-
-        m_nSpeakers = nSpeakers;
+        ConfigureFFTSize();
 
         //Allocate buffers with new settings
         AllocateBuffers();
+        std::shared_ptr<CBinauralFilterSet> pFilters = std::make_shared<CBinauralFilterSet>(m_nTaps, m_nFFTSize, m_nPartitions, m_nChannelCount);
 
         //Allocate temporary buffers for retrieving taps from mit_hrtf_lib
         float* pfHRTF[2];
@@ -122,11 +134,7 @@ bool SpeakersBinauralizer::Configure(unsigned nSampleRate,
         for(niEar = 0; niEar < 2; niEar++)
         {
             for (unsigned niChannel = 0; niChannel < nSpeakers; niChannel++)
-            {
-                memcpy(m_pfScratchBufferA.data(), ppfAccumulator[niEar][niChannel], m_nTaps * sizeof(float));
-                memset(&m_pfScratchBufferA[m_nTaps], 0, (m_nFFTSize - m_nTaps) * sizeof(float));
-                kiss_fftr(m_pFFT_cfg.get(), m_pfScratchBufferA.data(), m_ppcpFilters[niEar][niChannel].get());
-            }
+                ConvertFilter(ppfAccumulator[niEar][niChannel], pFilters->GetFilter(niEar, niChannel));
         }
 
         for(niEar = 0; niEar < 2; niEar++)
@@ -139,54 +147,30 @@ bool SpeakersBinauralizer::Configure(unsigned nSampleRate,
             delete [] ppfAccumulator[niEar];
         }
 
+        ShareFilters(sFilterKey, pFilters);
+
     return true;
 }
 
 
 void SpeakersBinauralizer::Process(float** pBFSrc, float** ppfDst)
 {
-    kiss_fft_cpx cpTemp;
-
-    for (unsigned niEar = 0; niEar < 2; niEar++)
-    {
-        memset(m_pfScratchBufferA.data(), 0, m_nFFTSize * sizeof(float));
-        for (unsigned niChannel = 0; niChannel < m_nSpeakers; niChannel++)
-        {
-            memcpy(m_pfScratchBufferB.data(), pBFSrc[niChannel], m_nBlockSize * sizeof(float));
-            memset(&m_pfScratchBufferB[m_nBlockSize], 0, (m_nFFTSize - m_nBlockSize) * sizeof(float));
-            kiss_fftr(m_pFFT_cfg.get(), m_pfScratchBufferB.data(), m_pcpScratch.get());
-            for(unsigned ni = 0; ni < m_nFFTBins; ni++)
-            {
-                cpTemp.r = m_pcpScratch[ni].r * m_ppcpFilters[niEar][niChannel][ni].r
-                    - m_pcpScratch[ni].i * m_ppcpFilters[niEar][niChannel][ni].i;
-                cpTemp.i = m_pcpScratch[ni].r * m_ppcpFilters[niEar][niChannel][ni].i
-                    + m_pcpScratch[ni].i * m_ppcpFilters[niEar][niChannel][ni].r;
-                m_pcpScratch[ni] = cpTemp;
-            }
-            kiss_fftri(m_pIFFT_cfg.get(), m_pcpScratch.get(), m_pfScratchBufferB.data());
-            for (unsigned ni = 0; ni < m_nFFTSize; ni++)
-                m_pfScratchBufferA[ni] += m_pfScratchBufferB[ni];
-        }
+    // The spectrum of each speaker feed is computed once and shared by both ears. The products with the
+    // HRTFs are accumulated in one bin buffer per ear followed by a single inverse FFT per ear.
+    ProcessConvolution(pBFSrc, ppfDst, false);
+}
 
-        for (unsigned ni = 0; ni < m_nFFTSize; ni++)
-            m_pfScratchBufferA[ni] *= m_fFFTScaler;
-        memcpy(ppfDst[niEar], m_pfScratchBufferA.data(), m_nBlockSize * sizeof(float));
-        for (unsigned ni = 0; ni < m_nOverlapLength; ni++)
-            ppfDst[niEar][ni] += m_pfOverlap[niEar][ni];
-        memcpy(m_pfOverlap[niEar].data(), &m_pfScratchBufferA[m_nBlockSize], m_nOverlapLength * sizeof(float));
-    }
+void SpeakersBinauralizer::Process(float** ppfSrc, float** ppfDst, unsigned nSamples)
+{
+    ProcessBuffered(ppfSrc, ppfDst, nSamples);
 }
 
+bool SpeakersBinauralizer::ConfigureAsync(unsigned, bool, unsigned, unsigned, std::string, bool)
+{
+    return false;
+}
 
-void SpeakersBinauralizer::AllocateBuffers()
+void SpeakersBinauralizer::ProcessFifoBlock(float** ppfDst)
 {
-    CAmbisonicBinauralizer::AllocateBuffers();
-
-    //Allocate the FFTBins for each channel, for each ear
-    for(unsigned niEar = 0; niEar < 2; niEar++)
-    {
-        m_ppcpFilters[niEar].resize(m_nSpeakers);
-        for(unsigned niChannel = 0; niChannel < m_nSpeakers; niChannel++)
-            m_ppcpFilters[niEar][niChannel].reset(new kiss_fft_cpx[m_nFFTBins]);
-    }
+    ProcessConvolution(m_ppfInputFifoChannels.data(), ppfDst, false);
 }
@@ -0,0 +1,50 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  FFT - Real FFT Interface                                                #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      fft.cpp                                                  #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "config.h"
+
+#include "fft.h"
+#include "kissfft_fft.h"
+#include "fftw_fft.h"
+#include "pffft_fft.h"
+#include "pocketfft_fft.h"
+
+
+FFT* createFFT(unsigned i_size)
+{
+    FFT *p_fft = nullptr;
+
+#if defined(HAVE_PFFFT)
+    p_fft = new PFFFT_FFT(i_size);
+#elif defined(HAVE_FFTW)
+    p_fft = new FFTW_FFT(i_size);
+#elif defined(HAVE_POCKETFFT)
+    p_fft = new POCKETFFT_FFT(i_size);
+#endif
+
+    if (p_fft != nullptr && p_fft->isReady())
+        return p_fft;
+    delete p_fft;
+
+    // Fall back to the bundled kiss_fft
+    p_fft = new KISS_FFT(i_size);
+    if (!p_fft->isReady())
+    {
+        delete p_fft;
+        return nullptr;
+    }
+
+    return p_fft;
+}
@@ -0,0 +1,71 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  FFTW_FFT - FFTW Backend                                                 #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      fftw_fft.cpp                                             #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "fftw_fft.h"
+
+#ifdef HAVE_FFTW
+
+#include <mutex>
+#include <vector>
+
+static_assert(sizeof(kiss_fft_cpx) == sizeof(fftwf_complex), "kiss_fft_cpx and fftwf_complex layouts differ");
+
+// Only the fftwf_execute functions are thread-safe. Plans are made and destroyed by ConfigureAsync()
+// on a background thread, while other objects may be configured on other threads.
+static std::mutex planMutex;
+
+FFTW_FFT::FFTW_FFT(unsigned i_size)
+    : FFT(i_size), forwardPlan(nullptr), inversePlan(nullptr)
+{
+    // The plans are made on temporary arrays and executed on the caller's buffers with the
+    // new-array execute functions, so they must not assume any alignment.
+    // FFTW_PRESERVE_INPUT is needed as the complex to real transform destroys its input by default.
+    std::vector<float> pfTime(i_size);
+    std::vector<kiss_fft_cpx> pcpFreq(i_size / 2 + 1);
+    fftwf_complex* pFreq = reinterpret_cast<fftwf_complex*>(pcpFreq.data());
+
+    std::lock_guard<std::mutex> lock(planMutex);
+    forwardPlan = fftwf_plan_dft_r2c_1d(i_size, pfTime.data(), pFreq,
+                                        FFTW_ESTIMATE | FFTW_UNALIGNED);
+    inversePlan = fftwf_plan_dft_c2r_1d(i_size, pFreq, pfTime.data(),
+                                        FFTW_ESTIMATE | FFTW_UNALIGNED | FFTW_PRESERVE_INPUT);
+    b_ready = forwardPlan != nullptr && inversePlan != nullptr;
+}
+
+
+FFTW_FFT::~FFTW_FFT()
+{
+    std::lock_guard<std::mutex> lock(planMutex);
+    if (forwardPlan != nullptr)
+        fftwf_destroy_plan(forwardPlan);
+    if (inversePlan != nullptr)
+        fftwf_destroy_plan(inversePlan);
+}
+
+
+void FFTW_FFT::forward(const float* pfTime, kiss_fft_cpx* pcpFreq)
+{
+    fftwf_execute_dft_r2c(forwardPlan, const_cast<float*>(pfTime),
+                          reinterpret_cast<fftwf_complex*>(pcpFreq));
+}
+
+
+void FFTW_FFT::inverse(const kiss_fft_cpx* pcpFreq, float* pfTime)
+{
+    fftwf_execute_dft_c2r(inversePlan,
+                          reinterpret_cast<fftwf_complex*>(const_cast<kiss_fft_cpx*>(pcpFreq)), pfTime);
+}
+
+#endif
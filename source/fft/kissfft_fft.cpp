@@ -0,0 +1,44 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  KISS_FFT - kiss_fft Backend                                             #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      kissfft_fft.cpp                                          #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "kissfft_fft.h"
+
+
+KISS_FFT::KISS_FFT(unsigned i_size)
+    : FFT(i_size)
+{
+    forwardCfg = kiss_fftr_alloc(i_size, 0, nullptr, nullptr);
+    inverseCfg = kiss_fftr_alloc(i_size, 1, nullptr, nullptr);
+    b_ready = forwardCfg != nullptr && inverseCfg != nullptr;
+}
+
+
+KISS_FFT::~KISS_FFT()
+{
+    kiss_fftr_free(forwardCfg);
+    kiss_fftr_free(inverseCfg);
+}
+
+
+void KISS_FFT::forward(const float* pfTime, kiss_fft_cpx* pcpFreq)
+{
+    kiss_fftr(forwardCfg, pfTime, pcpFreq);
+}
+
+
+void KISS_FFT::inverse(const kiss_fft_cpx* pcpFreq, float* pfTime)
+{
+    kiss_fftri(inverseCfg, pcpFreq, pfTime);
+}
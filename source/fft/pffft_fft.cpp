@@ -0,0 +1,78 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  PFFFT_FFT - PFFFT Backend                                               #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      pffft_fft.cpp                                            #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "pffft_fft.h"
+
+#ifdef HAVE_PFFFT
+
+#include <cstring>
+
+PFFFT_FFT::PFFFT_FFT(unsigned i_size)
+    : FFT(i_size), setup(nullptr), pfIn(nullptr), pfOut(nullptr), pfWork(nullptr)
+{
+    // The SIMD real transform needs a multiple of 32. pffft_new_setup() asserts on other sizes rather
+    // than failing, so they are rejected here and createFFT() falls back to kiss_fft.
+    if (i_size == 0 || i_size % 32 != 0)
+        return;
+    setup = pffft_new_setup(i_size, PFFFT_REAL);
+    if (setup == nullptr)
+        return;
+
+    pfIn = (float*)pffft_aligned_malloc(i_size * sizeof(float));
+    pfOut = (float*)pffft_aligned_malloc(i_size * sizeof(float));
+    pfWork = (float*)pffft_aligned_malloc(i_size * sizeof(float));
+    b_ready = pfIn != nullptr && pfOut != nullptr && pfWork != nullptr;
+}
+
+
+PFFFT_FFT::~PFFFT_FFT()
+{
+    if (setup != nullptr)
+        pffft_destroy_setup(setup);
+    pffft_aligned_free(pfIn);
+    pffft_aligned_free(pfOut);
+    pffft_aligned_free(pfWork);
+}
+
+
+void PFFFT_FFT::forward(const float* pfTime, kiss_fft_cpx* pcpFreq)
+{
+    unsigned nBins = i_size / 2;
+
+    memcpy(pfIn, pfTime, i_size * sizeof(float));
+    pffft_transform_ordered(setup, pfIn, pfOut, pfWork, PFFFT_FORWARD);
+
+    // The ordered output packs the real DC and Nyquist bins into the first complex value
+    pcpFreq[0].r = pfOut[0];
+    pcpFreq[0].i = 0.f;
+    pcpFreq[nBins].r = pfOut[1];
+    pcpFreq[nBins].i = 0.f;
+    memcpy(&pcpFreq[1], &pfOut[2], (nBins - 1) * sizeof(kiss_fft_cpx));
+}
+
+
+void PFFFT_FFT::inverse(const kiss_fft_cpx* pcpFreq, float* pfTime)
+{
+    unsigned nBins = i_size / 2;
+
+    pfIn[0] = pcpFreq[0].r;
+    pfIn[1] = pcpFreq[nBins].r;
+    memcpy(&pfIn[2], &pcpFreq[1], (nBins - 1) * sizeof(kiss_fft_cpx));
+    pffft_transform_ordered(setup, pfIn, pfOut, pfWork, PFFFT_BACKWARD);
+
+    memcpy(pfTime, pfOut, i_size * sizeof(float));
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  POCKETFFT_FFT - pocketfft Backend                                       #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      pocketfft_fft.cpp                                        #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "pocketfft_fft.h"
+
+#ifdef HAVE_POCKETFFT
+
+// Only 1D transforms are used, the thread pool is not needed
+#define POCKETFFT_NO_MULTITHREADING
+#include <pocketfft_hdronly.h>
+
+POCKETFFT_FFT::POCKETFFT_FFT(unsigned i_size)
+    : FFT(i_size), pfBuffer(i_size)
+{
+    plan.reset(new pocketfft::detail::pocketfft_r<float>(i_size));
+    b_ready = true;
+}
+
+
+POCKETFFT_FFT::~POCKETFFT_FFT()
+{
+}
+
+
+void POCKETFFT_FFT::forward(const float* pfTime, kiss_fft_cpx* pcpFreq)
+{
+    unsigned nBins = i_size / 2;
+
+    // pocketfft works in place using the FFTPACK half-complex order r0, r1, i1, r2, i2, ..., r(n/2)
+    std::copy(pfTime, pfTime + i_size, pfBuffer.begin());
+    plan->exec(pfBuffer.data(), 1.f, true);
+
+    pcpFreq[0].r = pfBuffer[0];
+    pcpFreq[0].i = 0.f;
+    for (unsigned k = 1; k < nBins; k++)
+    {
+        pcpFreq[k].r = pfBuffer[2 * k - 1];
+        pcpFreq[k].i = pfBuffer[2 * k];
+    }
+    pcpFreq[nBins].r = pfBuffer[i_size - 1];
+    pcpFreq[nBins].i = 0.f;
+}
+
+
+void POCKETFFT_FFT::inverse(const kiss_fft_cpx* pcpFreq, float* pfTime)
+{
+    unsigned nBins = i_size / 2;
+
+    pfTime[0] = pcpFreq[0].r;
+    for (unsigned k = 1; k < nBins; k++)
+    {
+        pfTime[2 * k - 1] = pcpFreq[k].r;
+        pfTime[2 * k] = pcpFreq[k].i;
+    }
+    pfTime[i_size - 1] = pcpFreq[nBins].r;
+    plan->exec(pfTime, 1.f, false);
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*############################################################################*/
+/*#                                                                          #*/
+/*#  Ambisonic C++ Library                                                   #*/
+/*#  Complex Multiply-Accumulate Kernels                                     #*/
+/*#  Copyright © 2026 libspatialaudio contributors                           #*/
+/*#                                                                          #*/
+/*#  Filename:      spectrum.cpp                                             #*/
+/*#  Version:       0.1                                                      #*/
+/*#  Date:          18/10/2026                                               #*/
+/*#  Author(s):     libspatialaudio contributors                             #*/
+/*#  Licence:       LGPL                                                     #*/
+/*#                                                                          #*/
+/*############################################################################*/
+
+
+#include "spectrum.h"
+
+#if !defined(FIXED_POINT)
+# if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#  define SPECTRUM_SSE2 1
+#  include <emmintrin.h>
+#  if defined(__GNUC__)
+#   define SPECTRUM_AVX2 1
+#   include <immintrin.h>
+#  endif
+# elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define SPECTRUM_NEON 1
+#  include <arm_neon.h>
+# endif
+#endif
+
+namespace {
+    template<bool bAccumulate>
+    void spectrumC(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins)
+    {
+        for(unsigned ni = 0; ni < nBins; ni++)
+        {
+            kiss_fft_cpx cpTemp;
+            cpTemp.r = pcpA[ni].r * pcpB[ni].r - pcpA[ni].i * pcpB[ni].i;
+            cpTemp.i = pcpA[ni].r * pcpB[ni].i + pcpA[ni].i * pcpB[ni].r;
+            if(bAccumulate)
+            {
+                pcpDst[ni].r += cpTemp.r;
+                pcpDst[ni].i += cpTemp.i;
+            }
+            else
+                pcpDst[ni] = cpTemp;
+        }
+    }
+
+#if defined(SPECTRUM_SSE2)
+    template<bool bAccumulate>
+    void spectrumSSE2(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins)
+    {
+        // Two bins per register: (ar, ai) * (br, bi) = (ar br - ai bi, ai br + ar bi)
+        const __m128 fSign = _mm_castsi128_ps(_mm_set_epi32(0, (int)0x80000000, 0, (int)0x80000000));
+        float* pfDst = (float*)pcpDst;
+        unsigned ni = 0;
+        for(; ni + 2 <= nBins; ni += 2)
+        {
+            __m128 fA = _mm_loadu_ps((const float*)&pcpA[ni]);
+            __m128 fB = _mm_loadu_ps((const float*)&pcpB[ni]);
+            __m128 fBRe = _mm_shuffle_ps(fB, fB, _MM_SHUFFLE(2, 2, 0, 0));
+            __m128 fBIm = _mm_shuffle_ps(fB, fB, _MM_SHUFFLE(3, 3, 1, 1));
+            __m128 fASwap = _mm_shuffle_ps(fA, fA, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 fProduct = _mm_add_ps(_mm_mul_ps(fA, fBRe), _mm_xor_ps(_mm_mul_ps(fASwap, fBIm), fSign));
+            if(bAccumulate)
+                fProduct = _mm_add_ps(_mm_loadu_ps(&pfDst[2 * ni]), fProduct);
+            _mm_storeu_ps(&pfDst[2 * ni], fProduct);
+        }
+        spectrumC<bAccumulate>(&pcpA[ni], &pcpB[ni], &pcpDst[ni], nBins - ni);
+    }
+#endif
+
+#if defined(SPECTRUM_AVX2)
+    template<bool bAccumulate>
+    __attribute__((target("avx2,fma")))
+    void spectrumAVX2(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins)
+    {
+        // Four bins per register, fmaddsub subtracts in the real lanes and adds in the imaginary ones
+        float* pfDst = (float*)pcpDst;
+        unsigned ni = 0;
+        for(; ni + 4 <= nBins; ni += 4)
+        {
+            __m256 fA = _mm256_loadu_ps((const float*)&pcpA[ni]);
+            __m256 fB = _mm256_loadu_ps((const float*)&pcpB[ni]);
+            __m256 fBRe = _mm256_moveldup_ps(fB);
+            __m256 fBIm = _mm256_movehdup_ps(fB);
+            __m256 fASwap = _mm256_permute_ps(fA, _MM_SHUFFLE(2, 3, 0, 1));
+            __m256 fProduct = _mm256_fmaddsub_ps(fA, fBRe, _mm256_mul_ps(fASwap, fBIm));
+            if(bAccumulate)
+                fProduct = _mm256_add_ps(_mm256_loadu_ps(&pfDst[2 * ni]), fProduct);
+            _mm256_storeu_ps(&pfDst[2 * ni], fProduct);
+        }
+        spectrumSSE2<bAccumulate>(&pcpA[ni], &pcpB[ni], &pcpDst[ni], nBins - ni);
+    }
+#endif
+
+#if defined(SPECTRUM_NEON)
+    template<bool bAccumulate>
+    void spectrumNEON(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins)
+    {
+        // Four bins per register, de-interleaved into real and imaginary parts by the loads
+        float* pfDst = (float*)pcpDst;
+        unsigned ni = 0;
+        for(; ni + 4 <= nBins; ni += 4)
+        {
+            float32x4x2_t fA = vld2q_f32((const float*)&pcpA[ni]);
+            float32x4x2_t fB = vld2q_f32((const float*)&pcpB[ni]);
+            float32x4x2_t fDst;
+            if(bAccumulate)
+                fDst = vld2q_f32(&pfDst[2 * ni]);
+            else
+            {
+                fDst.val[0] = vdupq_n_f32(0.f);
+                fDst.val[1] = vdupq_n_f32(0.f);
+            }
+            fDst.val[0] = vmlaq_f32(fDst.val[0], fA.val[0], fB.val[0]);
+            fDst.val[0] = vmlsq_f32(fDst.val[0], fA.val[1], fB.val[1]);
+            fDst.val[1] = vmlaq_f32(fDst.val[1], fA.val[0], fB.val[1]);
+            fDst.val[1] = vmlaq_f32(fDst.val[1], fA.val[1], fB.val[0]);
+            vst2q_f32(&pfDst[2 * ni], fDst);
+        }
+        spectrumC<bAccumulate>(&pcpA[ni], &pcpB[ni], &pcpDst[ni], nBins - ni);
+    }
+#endif
+
+    const unsigned knMaxKernels = 4;
+
+    /** Fills pKernels with the versions the CPU supports, the fastest last,
+        without allocating as it may first run in Process() */
+    unsigned getSupportedKernels(SpectrumKernel pKernels[knMaxKernels])
+    {
+        unsigned nKernels = 0;
+        pKernels[nKernels++] = {"c", spectrumC<false>, spectrumC<true>};
+#if defined(SPECTRUM_SSE2)
+        pKernels[nKernels++] = {"sse2", spectrumSSE2<false>, spectrumSSE2<true>};
+#endif
+#if defined(SPECTRUM_AVX2)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            pKernels[nKernels++] = {"avx2", spectrumAVX2<false>, spectrumAVX2<true>};
+#endif
+#if defined(SPECTRUM_NEON)
+        pKernels[nKernels++] = {"neon", spectrumNEON<false>, spectrumNEON<true>};
+#endif
+        return nKernels;
+    }
+
+    SpectrumKernel getFastestKernel()
+    {
+        SpectrumKernel pKernels[knMaxKernels];
+        return pKernels[getSupportedKernels(pKernels) - 1];
+    }
+
+    const SpectrumKernel& getKernel()
+    {
+        static const SpectrumKernel kernel = getFastestKernel();
+        return kernel;
+    }
+}
+
+void spectrumMultiply(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins)
+{
+    getKernel().multiply(pcpA, pcpB, pcpDst, nBins);
+}
+
+void spectrumMultiplyAccumulate(const kiss_fft_cpx* pcpA, const kiss_fft_cpx* pcpB, kiss_fft_cpx* pcpDst, unsigned nBins)
+{
+    getKernel().multiplyAccumulate(pcpA, pcpB, pcpDst, nBins);
+}
+
+const char* spectrumKernelName()
+{
+    return getKernel().name;
+}
+
+std::vector<SpectrumKernel> spectrumKernels()
+{
+    SpectrumKernel pKernels[knMaxKernels];
+    unsigned nKernels = getSupportedKernels(pKernels);
+    return std::vector<SpectrumKernel>(pKernels, pKernels + nKernels);
+}
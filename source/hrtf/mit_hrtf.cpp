@@ -7,12 +7,12 @@
 #include <mit_hrtf.h>
 #include <mit_hrtf_lib.h>
 
-#include <vector>
-
 MIT_HRTF::MIT_HRTF(unsigned i_sampleRate)
     : HRTF(i_sampleRate)
 {
     i_len = mit_hrtf_availability(0, 0, i_sampleRate);
+    psHRTF[0].resize(i_len);
+    psHRTF[1].resize(i_len);
 }
 
 
@@ -23,7 +23,6 @@ bool MIT_HRTF::get(float f_azimuth, float f_elevation, float** pfHRTF)
         nAzimuth -= 360;
     int nElevation = (int)RadiansToDegrees(f_elevation);
     //Get HRTFs for given position
-    std::vector<short> psHRTF[2] = {std::vector<short>(i_len), std::vector<short>(i_len)};
     unsigned ret = mit_hrtf_get(&nAzimuth, &nElevation, i_sampleRate, psHRTF[0].data(), psHRTF[1].data());
     if (ret == 0)
         return false;
@@ -8,7 +8,7 @@
 #include <cmath>
 #include <AmbisonicCommons.h>
 
-#include <vector>
+#include <algorithm>
 
 SOFA_HRTF::SOFA_HRTF(std::string path, unsigned i_sampleRate)
     : HRTF(i_sampleRate), hrtf(nullptr)
@@ -24,6 +24,8 @@ SOFA_HRTF::SOFA_HRTF(std::string path, unsigned i_sampleRate)
 
     i_filterExtraLength = i_internalLength / 2;
     i_len = i_internalLength + i_filterExtraLength;
+    pfHRTFNotDelayed[0].resize(i_internalLength);
+    pfHRTFNotDelayed[1].resize(i_internalLength);
 }
 
 
@@ -38,9 +40,8 @@ bool SOFA_HRTF::get(float f_azimuth, float f_elevation, float** pfHRTF)
 {
     float delaysSec[2]; // unit is second.
     unsigned delaysSamples[2]; // unit is samples.
-    std::vector<float> pfHRTFNotDelayed[2];
-    pfHRTFNotDelayed[0].resize( i_internalLength, 0.f );
-    pfHRTFNotDelayed[1].resize( i_internalLength, 0.f );
+    std::fill(pfHRTFNotDelayed[0].begin(), pfHRTFNotDelayed[0].end(), 0.f);
+    std::fill(pfHRTFNotDelayed[1].begin(), pfHRTFNotDelayed[1].end(), 0.f);
 
     float p[3] = {RadiansToDegrees(f_azimuth), RadiansToDegrees(f_elevation), 1.f};
     mysofa_s2c(p);
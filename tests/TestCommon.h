@@ -0,0 +1,69 @@
+/*
+    Helpers shared by the tests. Each test is a plain executable registered
+    with CTest: it prints one line per failed check and returns non-zero if
+    any check failed.
+*/
+
+#ifndef _TEST_COMMON_H
+#define _TEST_COMMON_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace test {
+    /** Number of failed checks, returned by main() */
+    static int nFailures = 0;
+
+    inline bool Check(bool bCondition, const char* pcWhat)
+    {
+        if(!bCondition)
+        {
+            fprintf(stderr, "FAILED: %s\n", pcWhat);
+            nFailures++;
+        }
+        return bCondition;
+    }
+
+    /** Uniform noise in [-0.5, 0.5), the same sequence for a given seed */
+    inline std::vector<float> Noise(unsigned nSamples, unsigned nSeed = 12345)
+    {
+        std::vector<float> pfNoise(nSamples);
+        for(unsigned ni = 0; ni < nSamples; ni++)
+        {
+            nSeed = nSeed * 1664525u + 1013904223u;
+            pfNoise[ni] = (nSeed >> 8) / 16777216.f - 0.5f;
+        }
+        return pfNoise;
+    }
+
+    /** Largest absolute difference between two buffers */
+    inline float MaxDifference(const float* pfA, const float* pfB, unsigned nSamples)
+    {
+        float fMax = 0.f;
+        for(unsigned ni = 0; ni < nSamples; ni++)
+            fMax = std::max(fMax, std::fabs(pfA[ni] - pfB[ni]));
+        return fMax;
+    }
+
+    /** Largest absolute value of a buffer */
+    inline float MaxAbs(const float* pfA, unsigned nSamples)
+    {
+        float fMax = 0.f;
+        for(unsigned ni = 0; ni < nSamples; ni++)
+            fMax = std::max(fMax, std::fabs(pfA[ni]));
+        return fMax;
+    }
+
+    inline int Result(const char* pcTest)
+    {
+        if(nFailures)
+            fprintf(stderr, "%s: %d check(s) failed\n", pcTest, nFailures);
+        else
+            printf("%s: all checks passed\n", pcTest);
+        return nFailures ? 1 : 0;
+    }
+}
+
+#endif // _TEST_COMMON_H
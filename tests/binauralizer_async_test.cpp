@@ -0,0 +1,152 @@
+/*
+    Background reconfiguration of the binauralizers. A CAmbisonicBinauralizer
+    switches to the configuration built by ConfigureAsync() at a block
+    boundary, and CollectGarbage() frees the state it switched from. A
+    switch to the same filters must not change the output at all, with or
+    without the crossfade and whether the filters are partitioned or not:
+    the new configuration goes on from the input already received.
+    SpeakersBinauralizer does not support ConfigureAsync() and must refuse
+    it, also when called through a CAmbisonicBinauralizer pointer.
+*/
+
+#include "config.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "SpeakersBinauralizer.h"
+
+#include "TestCommon.h"
+
+namespace {
+    const unsigned knSampleRate = 48000;
+    const unsigned knBlockSize = 256;
+    /** Blocks rendered by CheckIdenticalSwitch(), the switch happens in the
+        second one */
+    const unsigned knBlocks = 12;
+
+    /** Gives access to the list of configurations waiting to be freed */
+    class CBinauralizerProbe : public CAmbisonicBinauralizer
+    {
+    public:
+        bool HasRetiredConfigurations()
+        {
+            return m_pRetiredConfigurations.load() != nullptr;
+        }
+    };
+
+    void CheckSwitch(bool bCrossfade)
+    {
+        std::string sMode = bCrossfade ? " (crossfade)" : "";
+        CBinauralizerProbe binauralizer;
+        unsigned nTail = 0;
+        if(!test::Check(binauralizer.Configure(1, true, knSampleRate, knBlockSize, nTail), "Configure()"))
+            return;
+
+        // Same format, as for a change of HRTF, so the crossfade can be used
+        CBFormat bFormat;
+        bFormat.Configure(1, true, knBlockSize);
+        std::vector<float> pfEars[2] = {std::vector<float>(knBlockSize), std::vector<float>(knBlockSize)};
+        float* ppfEars[2] = {pfEars[0].data(), pfEars[1].data()};
+        binauralizer.Process(&bFormat, ppfEars);
+
+        test::Check(binauralizer.ConfigureAsync(1, true, knSampleRate, knBlockSize, "", bCrossfade), "ConfigureAsync()");
+        test::Check(binauralizer.WaitForConfigure(nTail), "WaitForConfigure()");
+        test::Check(binauralizer.IsConfigurePending(), "the configuration was switched to before Process()");
+
+        binauralizer.Process(&bFormat, ppfEars);
+        binauralizer.Process(&bFormat, ppfEars);
+        if(!test::Check(!binauralizer.IsConfigurePending(), ("the configuration was not switched to" + sMode).c_str()))
+            return;
+        test::Check(binauralizer.HasRetiredConfigurations(), ("no configuration was retired" + sMode).c_str());
+
+        binauralizer.CollectGarbage();
+        test::Check(!binauralizer.HasRetiredConfigurations(),
+                    ("CollectGarbage() did not free the old configuration" + sMode).c_str());
+    }
+
+    /** Render noise with two binauralizers configured alike, one of which
+        switches to a configuration built by ConfigureAsync() with the same
+        HRTF. Their outputs must be bit-identical. */
+    void CheckIdenticalSwitch(unsigned nBlockSize, bool bCrossfade)
+    {
+        std::string sWhat = "switch to the same filters, block " + std::to_string(nBlockSize)
+                            + (bCrossfade ? " (crossfade)" : "");
+        CAmbisonicBinauralizer reference, switched;
+        unsigned nTail = 0;
+        if(!test::Check(reference.Configure(1, true, knSampleRate, nBlockSize, nTail)
+                        && switched.Configure(1, true, knSampleRate, nBlockSize, nTail), "Configure()"))
+            return;
+
+        CBFormat bFormat;
+        bFormat.Configure(1, true, nBlockSize);
+        std::vector<float> pfEars[2][2];
+        float* ppfEars[2][2];
+        for(unsigned niBinauralizer = 0; niBinauralizer < 2; niBinauralizer++)
+            for(unsigned niEar = 0; niEar < 2; niEar++)
+            {
+                pfEars[niBinauralizer][niEar].resize(nBlockSize);
+                ppfEars[niBinauralizer][niEar] = pfEars[niBinauralizer][niEar].data();
+            }
+
+        bool bIdentical = true;
+        float fPeak = 0.f;
+        for(unsigned niBlock = 0; niBlock < knBlocks; niBlock++)
+        {
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+            {
+                std::vector<float> pfNoise = test::Noise(nBlockSize, 1 + niBlock * 16 + niChannel);
+                bFormat.InsertStream(pfNoise.data(), niChannel, nBlockSize);
+            }
+            if(niBlock == 1)
+            {
+                test::Check(switched.ConfigureAsync(1, true, knSampleRate, nBlockSize, "", bCrossfade),
+                            (sWhat + " ConfigureAsync()").c_str());
+                test::Check(switched.WaitForConfigure(nTail), (sWhat + " WaitForConfigure()").c_str());
+            }
+            reference.Process(&bFormat, ppfEars[0]);
+            switched.Process(&bFormat, ppfEars[1]);
+            for(unsigned niEar = 0; niEar < 2; niEar++)
+            {
+                bIdentical = bIdentical && pfEars[0][niEar] == pfEars[1][niEar];
+                fPeak = std::max(fPeak, test::MaxAbs(ppfEars[0][niEar], nBlockSize));
+            }
+        }
+        test::Check(!switched.IsConfigurePending(), (sWhat + " was not switched to").c_str());
+        test::Check(fPeak > 0.f, (sWhat + " output is silent").c_str());
+        test::Check(bIdentical, (sWhat + " changed the output").c_str());
+    }
+}
+
+int main()
+{
+#if defined(HAVE_MIT_HRTF)
+    CheckSwitch(false);
+    CheckSwitch(true);
+    // Blocks shorter than the MIT HRTF use the partitioned convolution
+    for(unsigned nBlockSize : {32u, knBlockSize})
+        for(bool bCrossfade : {false, true})
+            CheckIdenticalSwitch(nBlockSize, bCrossfade);
+
+    const unsigned nSpeakers = 2;
+    CAmbisonicSpeaker speakers[nSpeakers];
+    for(unsigned niSpeaker = 0; niSpeaker < nSpeakers; niSpeaker++)
+    {
+        speakers[niSpeaker].Configure(1, true, 0);
+        speakers[niSpeaker].SetPosition(PolarPoint{niSpeaker ? -0.5f : 0.5f, 0.f, 1.f});
+        speakers[niSpeaker].Refresh();
+    }
+    SpeakersBinauralizer speakersBinauralizer;
+    unsigned nTail = 0;
+    test::Check(speakersBinauralizer.Configure(knSampleRate, knBlockSize, speakers, nSpeakers, nTail),
+                "SpeakersBinauralizer Configure()");
+    CAmbisonicBinauralizer* pBinauralizer = &speakersBinauralizer;
+    test::Check(!pBinauralizer->ConfigureAsync(1, true, knSampleRate, knBlockSize),
+                "SpeakersBinauralizer accepted ConfigureAsync()");
+    test::Check(!speakersBinauralizer.IsConfigurePending(), "SpeakersBinauralizer has a pending configuration");
+#else
+    printf("Built without the MIT HRTF, nothing to check\n");
+#endif
+    return test::Result("binauralizer_async_test");
+}
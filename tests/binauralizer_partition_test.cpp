@@ -0,0 +1,150 @@
+/*
+    Uniformly partitioned convolution of CAmbisonicBinauralizer. With blocks
+    shorter than the MIT HRTF (140 taps at 48 kHz) the filters are split into
+    partitions and convolved through the frequency-domain delay line. The
+    output must match the unpartitioned convolution of a binauralizer whose
+    block is longer than the filters, on the same B-Format noise:
+    - sample for sample with the block Process(), which adds no latency;
+    - one block later with the Process() taking any number of samples, fed
+      with calls of varying sizes, as its FIFO delays the output by one block.
+    Both ears are checked with and without the symmetric head mode.
+*/
+
+#include "config.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "AmbisonicBinauralizer.h"
+
+#include "TestCommon.h"
+
+namespace {
+    const unsigned knSampleRate = 48000;
+    /** Block of the reference, longer than the filters */
+    const unsigned knReferenceBlockSize = 1024;
+    const unsigned knSamples = 8 * knReferenceBlockSize;
+    /** Largest difference allowed, relative to the peak of the output */
+    const float kfTolerance = 1e-4f;
+    /** Sizes of the successive calls to the buffered Process() */
+    const unsigned knCallSizes[] = {1, 7, 32, 100, 13, 64, 250, 31};
+    const unsigned knMaxCallSize = 250;
+
+    struct Binaural {
+        std::vector<float> pfEars[2];
+    };
+
+    /** B-Format noise, one buffer per channel */
+    std::vector<std::vector<float>> Input(unsigned nChannels)
+    {
+        std::vector<std::vector<float>> ppfInput;
+        for(unsigned niChannel = 0; niChannel < nChannels; niChannel++)
+            ppfInput.push_back(test::Noise(knSamples, 7 + niChannel));
+        return ppfInput;
+    }
+
+    /** Output of the block Process() at nBlockSize */
+    Binaural RenderBlocks(unsigned nOrder, bool bLowCPU, unsigned nBlockSize)
+    {
+        Binaural output;
+        CAmbisonicBinauralizer binauralizer;
+        unsigned nTail = 0;
+        if(!test::Check(binauralizer.Configure(nOrder, true, knSampleRate, nBlockSize, nTail),
+                        "Configure() with the MIT HRTF"))
+            return output;
+        binauralizer.SetLowCPU(bLowCPU);
+
+        CBFormat bFormat;
+        bFormat.Configure(nOrder, true, nBlockSize);
+        std::vector<std::vector<float>> ppfInput = Input(bFormat.GetChannelCount());
+        std::vector<float> pfEars[2] = {std::vector<float>(nBlockSize), std::vector<float>(nBlockSize)};
+        float* ppfEars[2] = {pfEars[0].data(), pfEars[1].data()};
+
+        for(unsigned niSample = 0; niSample < knSamples; niSample += nBlockSize)
+        {
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+                bFormat.InsertStream(&ppfInput[niChannel][niSample], niChannel, nBlockSize);
+            binauralizer.Process(&bFormat, ppfEars);
+            for(unsigned niEar = 0; niEar < 2; niEar++)
+                output.pfEars[niEar].insert(output.pfEars[niEar].end(), pfEars[niEar].begin(), pfEars[niEar].end());
+        }
+        return output;
+    }
+
+    /** Output of the buffered Process() at nBlockSize, called with knCallSizes in turn */
+    Binaural RenderBuffered(unsigned nOrder, bool bLowCPU, unsigned nBlockSize)
+    {
+        Binaural output;
+        CAmbisonicBinauralizer binauralizer;
+        unsigned nTail = 0;
+        if(!test::Check(binauralizer.Configure(nOrder, true, knSampleRate, nBlockSize, nTail),
+                        "Configure() with the MIT HRTF"))
+            return output;
+        binauralizer.SetLowCPU(bLowCPU);
+
+        CBFormat bFormat;
+        bFormat.Configure(nOrder, true, knMaxCallSize);
+        std::vector<std::vector<float>> ppfInput = Input(bFormat.GetChannelCount());
+        std::vector<float> pfEars[2] = {std::vector<float>(knMaxCallSize), std::vector<float>(knMaxCallSize)};
+        float* ppfEars[2] = {pfEars[0].data(), pfEars[1].data()};
+
+        unsigned niCall = 0;
+        for(unsigned niSample = 0; niSample < knSamples; niCall++)
+        {
+            unsigned nSamples = std::min(knCallSizes[niCall % (sizeof(knCallSizes) / sizeof(knCallSizes[0]))],
+                                         knSamples - niSample);
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+                bFormat.InsertStream(&ppfInput[niChannel][niSample], niChannel, nSamples);
+            binauralizer.Process(&bFormat, ppfEars, nSamples);
+            for(unsigned niEar = 0; niEar < 2; niEar++)
+                output.pfEars[niEar].insert(output.pfEars[niEar].end(), pfEars[niEar].begin(), pfEars[niEar].begin() + nSamples);
+            niSample += nSamples;
+        }
+        return output;
+    }
+
+    /** Compare output, delayed by nLatency samples, with the reference */
+    void Compare(const Binaural& reference, const Binaural& output, unsigned nLatency, const std::string& sWhat)
+    {
+        for(unsigned niEar = 0; niEar < 2; niEar++)
+        {
+            std::string sEar = niEar == 0 ? " left" : " right";
+            if(!test::Check(output.pfEars[niEar].size() == knSamples && reference.pfEars[niEar].size() == knSamples,
+                            (sWhat + " produced no output").c_str()))
+                return;
+            unsigned nSamples = knSamples - nLatency;
+            float fPeak = test::MaxAbs(reference.pfEars[niEar].data(), nSamples);
+            float fError = test::MaxDifference(reference.pfEars[niEar].data(), &output.pfEars[niEar][nLatency], nSamples);
+            test::Check(fPeak > 0.f, (sWhat + sEar + " ear is silent").c_str());
+            test::Check(fError <= kfTolerance * fPeak,
+                        (sWhat + sEar + " ear differs by " + std::to_string(fError / fPeak)).c_str());
+            // The FIFO outputs silence until its first block is convolved
+            if(nLatency)
+                test::Check(test::MaxAbs(output.pfEars[niEar].data(), nLatency) == 0.f,
+                            (sWhat + sEar + " ear is not delayed").c_str());
+        }
+    }
+}
+
+int main()
+{
+#if defined(HAVE_MIT_HRTF)
+    for(unsigned nOrder : {1u, 3u})
+        for(bool bLowCPU : {false, true})
+        {
+            Binaural reference = RenderBlocks(nOrder, bLowCPU, knReferenceBlockSize);
+            for(unsigned nBlockSize : {32u, 64u})
+            {
+                std::string sWhat = "order " + std::to_string(nOrder) + (bLowCPU ? " symmetric" : "")
+                                    + " block " + std::to_string(nBlockSize);
+                Compare(reference, RenderBlocks(nOrder, bLowCPU, nBlockSize), 0, sWhat);
+                Compare(reference, RenderBuffered(nOrder, bLowCPU, nBlockSize), nBlockSize, sWhat + " buffered");
+            }
+        }
+#else
+    printf("Built without the MIT HRTF, nothing to check\n");
+#endif
+    return test::Result("binauralizer_partition_test");
+}
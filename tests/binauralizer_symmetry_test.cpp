@@ -0,0 +1,97 @@
+/*
+    The symmetric head mode of CAmbisonicBinauralizer (SetLowCPU(true))
+    builds the right ear from the left ear filters, flipping the sign of the
+    channels that are odd in azimuth. With the MIT HRTFs, which are left-right
+    symmetric, it must give the same output as convolving both ears. This is
+    checked for orders 1 to 3 in 2D and 3D on B-Format noise, and for a switch
+    of mode between blocks.
+*/
+
+#include "config.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "AmbisonicBinauralizer.h"
+
+#include "TestCommon.h"
+
+namespace {
+    const unsigned knSampleRate = 48000;
+    const unsigned knBlockSize = 512;
+    const unsigned knBlocks = 8;
+    /** Largest difference allowed, relative to the peak of the output */
+    const float kfTolerance = 1e-4f;
+
+    struct Binaural {
+        std::vector<float> pfEars[2];
+    };
+
+    /** Output of knBlocks blocks of noise. bLowCPU is used from block
+        niSwitch on and !bLowCPU before it. */
+    Binaural Render(unsigned nOrder, bool b3D, bool bLowCPU, unsigned niSwitch = 0)
+    {
+        Binaural output;
+        CAmbisonicBinauralizer binauralizer;
+        unsigned nTail = 0;
+        if(!test::Check(binauralizer.Configure(nOrder, b3D, knSampleRate, knBlockSize, nTail),
+                        "Configure() with the MIT HRTF"))
+            return output;
+
+        CBFormat bFormat;
+        bFormat.Configure(nOrder, b3D, knBlockSize);
+        std::vector<float> pfEars[2] = {std::vector<float>(knBlockSize), std::vector<float>(knBlockSize)};
+        float* ppfEars[2] = {pfEars[0].data(), pfEars[1].data()};
+
+        for(unsigned niBlock = 0; niBlock < knBlocks; niBlock++)
+        {
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+            {
+                std::vector<float> pfNoise = test::Noise(knBlockSize, 1 + niBlock * 64 + niChannel);
+                bFormat.InsertStream(pfNoise.data(), niChannel, knBlockSize);
+            }
+            binauralizer.SetLowCPU(niBlock >= niSwitch ? bLowCPU : !bLowCPU);
+            binauralizer.Process(&bFormat, ppfEars);
+            for(unsigned niEar = 0; niEar < 2; niEar++)
+                output.pfEars[niEar].insert(output.pfEars[niEar].end(), pfEars[niEar].begin(), pfEars[niEar].end());
+        }
+        return output;
+    }
+
+    void Compare(const Binaural& full, const Binaural& symmetric, const std::string& sWhat)
+    {
+        for(unsigned niEar = 0; niEar < 2; niEar++)
+        {
+            unsigned nSamples = (unsigned)full.pfEars[niEar].size();
+            if(!test::Check(nSamples == knBlocks * knBlockSize && symmetric.pfEars[niEar].size() == nSamples,
+                            (sWhat + " produced no output").c_str()))
+                return;
+            float fPeak = test::MaxAbs(full.pfEars[niEar].data(), nSamples);
+            float fError = test::MaxDifference(full.pfEars[niEar].data(), symmetric.pfEars[niEar].data(), nSamples);
+            std::string sEar = niEar == 0 ? " left" : " right";
+            test::Check(fPeak > 0.f, (sWhat + sEar + " ear is silent").c_str());
+            test::Check(fError <= kfTolerance * fPeak,
+                        (sWhat + sEar + " ear differs by " + std::to_string(fError / fPeak)).c_str());
+        }
+    }
+}
+
+int main()
+{
+#if defined(HAVE_MIT_HRTF)
+    for(unsigned nOrder = 1; nOrder <= 3; nOrder++)
+        for(bool b3D : {false, true})
+        {
+            std::string sWhat = "order " + std::to_string(nOrder) + (b3D ? " 3D" : " 2D");
+            Binaural full = Render(nOrder, b3D, false);
+            Compare(full, Render(nOrder, b3D, true), sWhat);
+            // Switched to the symmetric mode, and back, half way through
+            Compare(full, Render(nOrder, b3D, true, knBlocks / 2), sWhat + " switched on");
+            Compare(full, Render(nOrder, b3D, false, knBlocks / 2), sWhat + " switched off");
+        }
+#else
+    printf("Built without the MIT HRTF, nothing to check\n");
+#endif
+    return test::Result("binauralizer_symmetry_test");
+}
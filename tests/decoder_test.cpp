@@ -0,0 +1,116 @@
+/*
+    Dual-band decoding of CAmbisonicDecoder. The high band is decoded with
+    max-rE gains normalised to keep the energy of the basic decoder used for
+    the low band, so on a regular layout a diffuse field must come out with
+    the same energy below and above the crossover. Sines well below and well
+    above it are encoded from directions evenly covering the circle (2D) or
+    the sphere (3D), and the energy summed over the speakers and directions
+    is compared for the two.
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Ambisonics.h"
+
+#include "TestCommon.h"
+
+namespace {
+    const unsigned knSampleRate = 48000;
+    const unsigned knBlockSize = 480;
+    /** Blocks run before measuring, for the crossovers to settle */
+    const unsigned knSettleBlocks = 10;
+    /** Blocks measured, a whole number of periods of both sines */
+    const unsigned knMeasureBlocks = 10;
+    const float kfCrossover = 1000.f;
+    const float kfLowFrequency = 100.f;
+    const float kfHighFrequency = 10000.f;
+    /** Largest difference allowed between the energies of the bands */
+    const float kfToleranceDB = 0.1f;
+
+    /** Evenly spread directions: a regular polygon in 2D, a Fibonacci
+        lattice in 3D */
+    std::vector<PolarPoint> Directions(bool b3D)
+    {
+        std::vector<PolarPoint> directions;
+        unsigned nDirections = b3D ? 500 : 36;
+        for(unsigned ni = 0; ni < nDirections; ni++)
+        {
+            if(b3D)
+            {
+                float fZ = 1.f - (2.f * ni + 1.f) / nDirections;
+                float fAzimuth = ni * (float)M_PI * (3.f - sqrtf(5.f));
+                directions.push_back(PolarPoint{fAzimuth, asinf(fZ), 1.f});
+            }
+            else
+                directions.push_back(PolarPoint{2.f * (float)M_PI * ni / nDirections, 0.f, 1.f});
+        }
+        return directions;
+    }
+
+    /** Energy of the speaker feeds for a sine of fFrequency, summed over the
+        speakers and the directions */
+    double DecodedEnergy(CAmbisonicDecoder& decoder, unsigned nOrder, bool b3D, float fFrequency)
+    {
+        CAmbisonicEncoder encoder;
+        encoder.Configure(nOrder, b3D, 0);
+        CBFormat bFormat;
+        bFormat.Configure(nOrder, b3D, knBlockSize);
+        unsigned nSpeakers = decoder.GetSpeakerCount();
+        std::vector<float> pfSpeakers(nSpeakers * knBlockSize);
+        std::vector<float*> ppfSpeakers(nSpeakers);
+        for(unsigned niSpeaker = 0; niSpeaker < nSpeakers; niSpeaker++)
+            ppfSpeakers[niSpeaker] = &pfSpeakers[niSpeaker * knBlockSize];
+        std::vector<float> pfSine(knBlockSize);
+
+        double dEnergy = 0.;
+        for(const PolarPoint& direction : Directions(b3D))
+        {
+            encoder.SetPosition(direction);
+            encoder.Refresh();
+            decoder.Reset();
+            for(unsigned niBlock = 0; niBlock < knSettleBlocks + knMeasureBlocks; niBlock++)
+            {
+                for(unsigned ni = 0; ni < knBlockSize; ni++)
+                    pfSine[ni] = sinf(2.f * (float)M_PI * fFrequency * (float)((niBlock * knBlockSize + ni) % knSampleRate) / knSampleRate);
+                encoder.Process(pfSine.data(), knBlockSize, &bFormat);
+                decoder.Process(&bFormat, knBlockSize, ppfSpeakers.data());
+                if(niBlock >= knSettleBlocks)
+                    for(float fSample : pfSpeakers)
+                        dEnergy += (double)fSample * fSample;
+            }
+        }
+        return dEnergy;
+    }
+
+    void CheckBandEnergies(int nSpeakerSetUp, unsigned nOrder, bool b3D, const std::string& sLayout)
+    {
+        std::string sWhat = sLayout + " order " + std::to_string(nOrder);
+        CAmbisonicDecoder decoder;
+        if(!test::Check(decoder.Configure(nOrder, b3D, nSpeakerSetUp), (sWhat + " Configure()").c_str()))
+            return;
+        decoder.SetDualBand(true, knSampleRate, kfCrossover);
+
+        double dLow = DecodedEnergy(decoder, nOrder, b3D, kfLowFrequency);
+        double dHigh = DecodedEnergy(decoder, nOrder, b3D, kfHighFrequency);
+        if(!test::Check(dLow > 0. && dHigh > 0., (sWhat + " is silent").c_str()))
+            return;
+        float fDifferenceDB = (float)(10. * log10(dHigh / dLow));
+        test::Check(std::fabs(fDifferenceDB) <= kfToleranceDB,
+                    (sWhat + " high band differs from the low band by " + std::to_string(fDifferenceDB) + " dB").c_str());
+    }
+}
+
+int main()
+{
+    for(unsigned nOrder = 1; nOrder <= 3; nOrder++)
+        CheckBandEnergies(kAmblib_Octagon, nOrder, false, "2D octagon");
+    CheckBandEnergies(kAmblib_Dodecadron, 4, false, "2D dodecagon");
+    CheckBandEnergies(kAmblib_Cube, 1, true, "3D cube");
+    for(unsigned nOrder = 1; nOrder <= 2; nOrder++)
+        CheckBandEnergies(kAmblib_Dodecahedron, nOrder, true, "3D dodecahedron");
+
+    return test::Result("decoder_test");
+}
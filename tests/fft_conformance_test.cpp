@@ -0,0 +1,176 @@
+/*
+    Conformance of the FFT backends. Every backend compiled in (see
+    FFT_BACKEND) and the transform returned by createFFT() run forward and
+    inverse transforms of noise over a range of sizes, and are compared with
+    the bundled kiss_fft. kiss_fft itself is checked against a direct DFT in
+    double precision.
+
+    The spectra must match within kfTolerance relative to the norm of the
+    reference spectrum, and so must the time signals. The inverse transform
+    is not normalised: inverse(forward(x)) must give getSize() * x.
+*/
+
+#include "config.h"
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fft.h"
+#include "kissfft_fft.h"
+#include "fftw_fft.h"
+#include "pffft_fft.h"
+#include "pocketfft_fft.h"
+
+#include "TestCommon.h"
+
+namespace {
+    /** Relative error allowed on a transform, about 100 float epsilons */
+    const float kfTolerance = 1e-5f;
+
+    /** Powers of two from 16 to 16384, and the usual block multiples */
+    const unsigned knSizes[] = {16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384,
+                                96, 160, 192, 384, 480, 640, 960, 1920, 2880};
+
+    /** Largest size checked against the direct DFT, which is O(n^2) */
+    const unsigned knMaxDirectSize = 2048;
+
+    struct Backend {
+        std::string sName;
+        std::function<FFT*(unsigned)> create;
+    };
+
+    std::vector<Backend> Backends()
+    {
+        std::vector<Backend> backends;
+#if defined(HAVE_PFFFT)
+        backends.push_back({"PFFFT", [](unsigned i_size) -> FFT* { return new PFFFT_FFT(i_size); }});
+#endif
+#if defined(HAVE_FFTW)
+        backends.push_back({"FFTW", [](unsigned i_size) -> FFT* { return new FFTW_FFT(i_size); }});
+#endif
+#if defined(HAVE_POCKETFFT)
+        backends.push_back({"pocketfft", [](unsigned i_size) -> FFT* { return new POCKETFFT_FFT(i_size); }});
+#endif
+        backends.push_back({"createFFT", [](unsigned i_size) { return createFFT(i_size); }});
+        return backends;
+    }
+
+    /** ||a - b|| / ||b|| over nValues floats */
+    double RelativeError(const float* pfA, const float* pfB, unsigned nValues)
+    {
+        double dError = 0., dNorm = 0.;
+        for(unsigned ni = 0; ni < nValues; ni++)
+        {
+            dError += ((double)pfA[ni] - pfB[ni]) * ((double)pfA[ni] - pfB[ni]);
+            dNorm += (double)pfB[ni] * pfB[ni];
+        }
+        return dNorm > 0. ? std::sqrt(dError / dNorm) : std::sqrt(dError);
+    }
+
+    void CheckError(double dError, const std::string& sWhat)
+    {
+        test::Check(dError <= kfTolerance, (sWhat + " error " + std::to_string(dError)).c_str());
+    }
+
+    /** Spectrum with zero imaginary parts at DC and Nyquist, as a real signal has */
+    std::vector<kiss_fft_cpx> RandomSpectrum(unsigned nSize, unsigned nSeed)
+    {
+        unsigned nBins = nSize / 2 + 1;
+        std::vector<float> pfValues = test::Noise(2 * nBins, nSeed);
+        std::vector<kiss_fft_cpx> pcpSpectrum(nBins);
+        for(unsigned ni = 0; ni < nBins; ni++)
+        {
+            pcpSpectrum[ni].r = pfValues[2 * ni];
+            pcpSpectrum[ni].i = pfValues[2 * ni + 1];
+        }
+        pcpSpectrum[0].i = 0.f;
+        pcpSpectrum[nBins - 1].i = 0.f;
+        return pcpSpectrum;
+    }
+
+    void CheckKissAgainstDFT(unsigned nSize)
+    {
+        KISS_FFT kiss(nSize);
+        unsigned nBins = nSize / 2 + 1;
+        std::vector<float> pfTime = test::Noise(nSize, nSize);
+        std::vector<kiss_fft_cpx> pcpFreq(nBins);
+        kiss.forward(pfTime.data(), pcpFreq.data());
+
+        std::vector<float> pfDFT(2 * nBins);
+        for(unsigned niBin = 0; niBin < nBins; niBin++)
+        {
+            double dReal = 0., dImag = 0.;
+            for(unsigned niSample = 0; niSample < nSize; niSample++)
+            {
+                double dPhase = -2. * M_PI * (double)((unsigned long long)niBin * niSample % nSize) / nSize;
+                dReal += pfTime[niSample] * std::cos(dPhase);
+                dImag += pfTime[niSample] * std::sin(dPhase);
+            }
+            pfDFT[2 * niBin] = (float)dReal;
+            pfDFT[2 * niBin + 1] = (float)dImag;
+        }
+        CheckError(RelativeError(&pcpFreq[0].r, pfDFT.data(), 2 * nBins),
+                   "kiss_fft forward vs DFT, size " + std::to_string(nSize));
+    }
+
+    void CheckBackend(const Backend& backend, unsigned nSize)
+    {
+        std::string sWhat = backend.sName + " size " + std::to_string(nSize);
+        std::unique_ptr<FFT> pFFT(backend.create(nSize));
+        if(!pFFT || !pFFT->isReady())
+        {
+            // A backend may not support every size, createFFT() then falls back to kiss_fft
+            test::Check(backend.sName != "createFFT", (sWhat + " could not be created").c_str());
+            return;
+        }
+        test::Check(pFFT->getSize() == nSize, (sWhat + " reports the wrong size").c_str());
+
+        KISS_FFT kiss(nSize);
+        unsigned nBins = nSize / 2 + 1;
+
+        // Forward: same spectrum as kiss_fft
+        std::vector<float> pfTime = test::Noise(nSize, 3 * nSize + 1);
+        std::vector<kiss_fft_cpx> pcpFreq(nBins), pcpKissFreq(nBins);
+        pFFT->forward(pfTime.data(), pcpFreq.data());
+        kiss.forward(pfTime.data(), pcpKissFreq.data());
+        CheckError(RelativeError(&pcpFreq[0].r, &pcpKissFreq[0].r, 2 * nBins), sWhat + " forward");
+        test::Check(pcpFreq[0].i == 0.f && pcpFreq[nBins - 1].i == 0.f,
+                    (sWhat + " forward has imaginary DC or Nyquist").c_str());
+
+        // Inverse: same signal as kiss_fft, and the spectrum is left untouched
+        std::vector<kiss_fft_cpx> pcpSpectrum = RandomSpectrum(nSize, 5 * nSize + 2);
+        std::vector<kiss_fft_cpx> pcpSpectrumCopy = pcpSpectrum;
+        std::vector<float> pfOut(nSize), pfKissOut(nSize);
+        pFFT->inverse(pcpSpectrum.data(), pfOut.data());
+        kiss.inverse(pcpSpectrum.data(), pfKissOut.data());
+        CheckError(RelativeError(pfOut.data(), pfKissOut.data(), nSize), sWhat + " inverse");
+        test::Check(RelativeError(&pcpSpectrum[0].r, &pcpSpectrumCopy[0].r, 2 * nBins) == 0.,
+                    (sWhat + " inverse modified its input").c_str());
+
+        // Round trip: the inverse is scaled by getSize()
+        pFFT->inverse(pcpFreq.data(), pfOut.data());
+        for(unsigned ni = 0; ni < nSize; ni++)
+            pfOut[ni] /= (float)nSize;
+        CheckError(RelativeError(pfOut.data(), pfTime.data(), nSize), sWhat + " round trip");
+    }
+}
+
+int main()
+{
+    for(unsigned nSize : knSizes)
+        if(nSize <= knMaxDirectSize)
+            CheckKissAgainstDFT(nSize);
+
+    for(const Backend& backend : Backends())
+    {
+        printf("Checking %s\n", backend.sName.c_str());
+        for(unsigned nSize : knSizes)
+            CheckBackend(backend, nSize);
+    }
+
+    return test::Result("fft_conformance_test");
+}
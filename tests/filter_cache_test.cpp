@@ -0,0 +1,211 @@
+/*
+    Binaural filter cache. CFilterCache must refuse an entry whose spectra
+    were altered or that was cut short, as the checksum or the size no longer
+    match. A binauralizer meeting such an entry must build the filters from
+    the HRTF again, give the same output as one without a cache, and write
+    the entry again. While another binauralizer holds the filters they are
+    taken from the registry and the cache is not read at all.
+*/
+
+#include "config.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+# include <dirent.h>
+# include <unistd.h>
+#endif
+
+#include "AmbisonicBinauralizer.h"
+#include "FilterCache.h"
+
+#include "TestCommon.h"
+
+namespace {
+#ifndef _WIN32
+    const unsigned knSampleRate = 48000;
+    const unsigned knBlockSize = 256;
+    const unsigned knOrder = 1;
+    const unsigned knBlocks = 8;
+
+    std::vector<unsigned char> ReadFile(const std::string& sPath)
+    {
+        std::vector<unsigned char> pData;
+        FILE* pFile = fopen(sPath.c_str(), "rb");
+        if(!pFile)
+            return pData;
+        int c;
+        while((c = fgetc(pFile)) != EOF)
+            pData.push_back((unsigned char)c);
+        fclose(pFile);
+        return pData;
+    }
+
+    void WriteFile(const std::string& sPath, const std::vector<unsigned char>& pData)
+    {
+        FILE* pFile = fopen(sPath.c_str(), "wb");
+        if(!pFile)
+            return;
+        fwrite(pData.data(), 1, pData.size(), pFile);
+        fclose(pFile);
+    }
+
+    /** Names of the files in sDirectory */
+    std::vector<std::string> ListFiles(const std::string& sDirectory)
+    {
+        std::vector<std::string> sFiles;
+        DIR* pDir = opendir(sDirectory.c_str());
+        if(!pDir)
+            return sFiles;
+        while(struct dirent* pEntry = readdir(pDir))
+        {
+            std::string sName = pEntry->d_name;
+            if(sName != "." && sName != "..")
+                sFiles.push_back(sName);
+        }
+        closedir(pDir);
+        return sFiles;
+    }
+
+    /** The entry with a byte of the spectra of the left ear flipped */
+    std::vector<unsigned char> Corrupted(std::vector<unsigned char> pData)
+    {
+        pData[pData.size() / 4] ^= 0xff;
+        return pData;
+    }
+
+    /** The entry cut in half */
+    std::vector<unsigned char> Truncated(std::vector<unsigned char> pData)
+    {
+        pData.resize(pData.size() / 2);
+        return pData;
+    }
+
+    void CheckCacheEntry(const std::string& sDirectory)
+    {
+        const std::string sKey = "filter_cache_test";
+        CBinauralFilterSet filters(64, 128, 1, 4);
+        for(unsigned niEar = 0; niEar < 2; niEar++)
+            for(unsigned niChannel = 0; niChannel < filters.GetChannelCount(); niChannel++)
+            {
+                std::vector<float> pfNoise = test::Noise(2 * filters.GetFilterSize(), 1 + niEar * 4 + niChannel);
+                for(unsigned ni = 0; ni < filters.GetFilterSize(); ni++)
+                    filters.GetFilter(niEar, niChannel)[ni] = {pfNoise[2 * ni], pfNoise[2 * ni + 1]};
+            }
+
+        CFilterCache cache;
+        cache.SetDirectory(sDirectory);
+        if(!test::Check(cache.Store(sKey, filters), "Store()"))
+            return;
+        std::vector<std::string> sFiles = ListFiles(sDirectory);
+        if(!test::Check(sFiles.size() == 1, "Store() did not leave exactly one file"))
+            return;
+        std::string sPath = sDirectory + "/" + sFiles[0];
+
+        bool bSame = cache.Open(sKey) && cache.GetChannelCount() == filters.GetChannelCount();
+        for(unsigned niEar = 0; bSame && niEar < 2; niEar++)
+            for(unsigned niChannel = 0; niChannel < filters.GetChannelCount(); niChannel++)
+                bSame = bSame && memcmp(cache.GetFilter(niEar, niChannel), filters.GetFilter(niEar, niChannel),
+                                        filters.GetFilterSize() * sizeof(kiss_fft_cpx)) == 0;
+        cache.Close();
+        test::Check(bSame, "Open() does not give the stored filters");
+        test::Check(!cache.Open(sKey + " other"), "Open() found an entry never stored");
+
+        std::vector<unsigned char> pEntry = ReadFile(sPath);
+        WriteFile(sPath, Corrupted(pEntry));
+        test::Check(!cache.Open(sKey), "Open() accepted an entry with a wrong checksum");
+        WriteFile(sPath, Truncated(pEntry));
+        test::Check(!cache.Open(sKey), "Open() accepted a truncated entry");
+        remove(sPath.c_str());
+    }
+
+# if defined(HAVE_MIT_HRTF)
+    /** Output of a binauralizer, configured with the filter cache in sDirectory if not empty */
+    std::vector<float> Render(const std::string& sDirectory)
+    {
+        std::vector<float> pfOutput;
+        CAmbisonicBinauralizer binauralizer;
+        binauralizer.SetFilterCacheDirectory(sDirectory);
+        unsigned nTail = 0;
+        if(!test::Check(binauralizer.Configure(knOrder, true, knSampleRate, knBlockSize, nTail),
+                        "Configure() with the MIT HRTF"))
+            return pfOutput;
+
+        CBFormat bFormat;
+        bFormat.Configure(knOrder, true, knBlockSize);
+        std::vector<float> pfEars[2] = {std::vector<float>(knBlockSize), std::vector<float>(knBlockSize)};
+        float* ppfEars[2] = {pfEars[0].data(), pfEars[1].data()};
+        for(unsigned niBlock = 0; niBlock < knBlocks; niBlock++)
+        {
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+            {
+                std::vector<float> pfNoise = test::Noise(knBlockSize, 100 * niBlock + niChannel);
+                bFormat.InsertStream(pfNoise.data(), niChannel, knBlockSize);
+            }
+            binauralizer.Process(&bFormat, ppfEars);
+            for(unsigned niEar = 0; niEar < 2; niEar++)
+                pfOutput.insert(pfOutput.end(), pfEars[niEar].begin(), pfEars[niEar].end());
+        }
+        return pfOutput;
+    }
+
+    void CheckBinauralizer(const std::string& sDirectory)
+    {
+        // Each binauralizer is gone before the next one is configured, so the
+        // registry holds no filters and the cache is read
+        std::vector<float> pfReference = Render("");
+        std::vector<float> pfStored = Render(sDirectory);
+        std::vector<std::string> sFiles = ListFiles(sDirectory);
+        if(!test::Check(sFiles.size() == 1, "Configure() did not store exactly one file")
+           || !test::Check(!pfReference.empty() && pfStored == pfReference, "the output differs with a cache"))
+            return;
+        std::string sPath = sDirectory + "/" + sFiles[0];
+        std::vector<unsigned char> pEntry = ReadFile(sPath);
+
+        test::Check(Render(sDirectory) == pfReference, "the output differs with the filters from the cache");
+
+        WriteFile(sPath, Corrupted(pEntry));
+        test::Check(Render(sDirectory) == pfReference, "the output differs after a corrupted entry");
+        test::Check(ReadFile(sPath) == pEntry, "a corrupted entry was not written again");
+
+        WriteFile(sPath, Truncated(pEntry));
+        test::Check(Render(sDirectory) == pfReference, "the output differs after a truncated entry");
+        test::Check(ReadFile(sPath) == pEntry, "a truncated entry was not written again");
+
+        // While a binauralizer holds the filters, the others take them from
+        // the registry and leave the cache alone
+        {
+            CAmbisonicBinauralizer holder;
+            unsigned nTail = 0;
+            holder.Configure(knOrder, true, knSampleRate, knBlockSize, nTail);
+            WriteFile(sPath, Truncated(pEntry));
+            test::Check(Render(sDirectory) == pfReference, "the output differs with the filters of the registry");
+            test::Check(ReadFile(sPath) == Truncated(pEntry), "the cache was read with the filters in the registry");
+        }
+
+        remove(sPath.c_str());
+        test::Check(ListFiles(sDirectory).empty(), "temporary files were left behind");
+    }
+# endif
+#endif
+}
+
+int main()
+{
+#ifndef _WIN32
+    char pcDirectory[] = "/tmp/filter_cache_test.XXXXXX";
+    if(!test::Check(mkdtemp(pcDirectory) != nullptr, "mkdtemp()"))
+        return test::Result("filter_cache_test");
+    CheckCacheEntry(pcDirectory);
+# if defined(HAVE_MIT_HRTF)
+    CheckBinauralizer(pcDirectory);
+# endif
+    rmdir(pcDirectory);
+#else
+    printf("Only checked on POSIX systems\n");
+#endif
+    return test::Result("filter_cache_test");
+}
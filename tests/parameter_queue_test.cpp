@@ -0,0 +1,87 @@
+/*
+    CParameterQueue: PopLatest() returns the latest value pushed, however
+    many were pushed since the last call, and only once. With a producer and
+    a consumer thread the consumer never sees an older value after a newer
+    one and ends with the last one. A copy starts empty. The classes holding
+    a mailbox stay copyable.
+*/
+
+#include <thread>
+#include <type_traits>
+
+#include "Ambisonics.h"
+#include "ParameterQueue.h"
+
+#include "TestCommon.h"
+
+#define CHECK_COPYABLE(T) \
+    static_assert(std::is_copy_constructible<T>::value && std::is_copy_assignable<T>::value, #T " is not copyable");
+
+CHECK_COPYABLE(CAmbisonicSource)
+CHECK_COPYABLE(CAmbisonicEncoder)
+CHECK_COPYABLE(CAmbisonicEncoderDist)
+CHECK_COPYABLE(CAmbisonicSpeaker)
+CHECK_COPYABLE(CAmbisonicMicrophone)
+
+int main()
+{
+    CParameterQueue<int> queue(0);
+    int nValue = -1;
+
+    test::Check(!queue.PopLatest(nValue), "an empty mailbox popped a value");
+    queue.Push(1);
+    test::Check(queue.PopLatest(nValue) && nValue == 1, "PopLatest() did not return the value pushed");
+    test::Check(!queue.PopLatest(nValue), "a value was popped twice");
+    // The consumer stalled while many values were posted: only the latest one matters
+    for(int ni = 2; ni < 100; ni++)
+        queue.Push(ni);
+    test::Check(queue.PopLatest(nValue) && nValue == 99, "PopLatest() did not return the latest value");
+    test::Check(!queue.PopLatest(nValue), "PopLatest() did not empty the mailbox");
+
+    queue.Push(5);
+    CParameterQueue<int> copy(queue);
+    test::Check(!copy.PopLatest(nValue), "a copied mailbox was not empty");
+    copy.Push(6);
+    test::Check(copy.PopLatest(nValue) && nValue == 6, "a copied mailbox does not work");
+    copy = queue;
+    test::Check(!copy.PopLatest(nValue), "an assigned mailbox was not empty");
+    test::Check(queue.PopLatest(nValue) && nValue == 5, "copying changed the original mailbox");
+
+    // One producer and one consumer thread
+    const int nValues = 200000;
+    CParameterQueue<int> shared(0);
+    std::thread producer([&] {
+        for(int ni = 1; ni <= nValues; ni++)
+            shared.Push(ni);
+    });
+    int nLast = 0;
+    bool bOrdered = true;
+    while(nLast < nValues)
+    {
+        if(shared.PopLatest(nValue))
+        {
+            bOrdered = bOrdered && nValue > nLast;
+            nLast = nValue;
+        }
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    test::Check(bOrdered, "the consumer saw an older value after a newer one");
+    test::Check(nLast == nValues, "the consumer did not end with the last value");
+
+    // A copied encoder processes its own posted positions
+    CAmbisonicEncoder encoder;
+    encoder.Configure(1, true, 0);
+    encoder.PostPosition(PolarPoint{1.f, 0.f, 1.f});
+    CAmbisonicEncoder encoderCopy(encoder);
+    CBFormat bFormat;
+    bFormat.Configure(1, true, 16);
+    std::vector<float> pfIn(16, 1.f);
+    encoderCopy.Process(pfIn.data(), 16, &bFormat);
+    test::Check(encoderCopy.GetPosition().fAzimuth == 0.f, "a copied encoder applied the posted position of the original");
+    encoder.Process(pfIn.data(), 16, &bFormat);
+    test::Check(encoder.GetPosition().fAzimuth == 1.f, "the original encoder lost its posted position");
+
+    return test::Result("parameter_queue_test");
+}
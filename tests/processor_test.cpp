@@ -0,0 +1,266 @@
+/*
+    CAmbisonicProcessor at every order from 0 to 5 with each of the
+    shelf-filters. Configure() must succeed and Process() must give a finite
+    output. At order 0 there is nothing to rotate and no shelf-filter, so the
+    W channel must come out unchanged, in 2D as in 3D. The rotations expect
+    3D input, so the higher orders are only checked in 3D.
+
+    The rotation matrices of orders 1 to 7 are checked by rotating sources
+    encoded in several directions and comparing with the same sources
+    encoded in the rotated directions. The processor turns the soundfield by
+    the inverse of the orientation, a direction v going to
+    (Rz(yaw) Ry(pitch) Rx(roll))^T v.
+
+    The minimum phase shelf-filters (kShelfIIR) must follow the magnitude
+    response of the linear phase FIR ones they replace within
+    kfShelfToleranceDB at frequencies across the band. In 3D the impulse
+    responses of both are measured through Process() at orders 1 to 3. In 2D,
+    where Process() cannot be used, the same responses are built from the
+    filter tables.
+*/
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "AmbisonicEncoder.h"
+#include "AmbisonicProcessor.h"
+#include "AmbisonicPsychoacousticFilters.h"
+#include "Biquad.h"
+
+#include "TestCommon.h"
+
+namespace {
+    const unsigned knBlockSize = 512;
+    const unsigned knBlocks = 4;
+    /** Largest error allowed on a rotated SN3D coefficient */
+    const float kfRotationTolerance = 1e-4f;
+
+    /** Largest difference allowed between the IIR and FIR shelf-filters */
+    const float kfShelfToleranceDB = 0.5f;
+    /** Frequencies checked, relative to the sample rate */
+    const double kpdShelfFrequencies[] = {0.002, 0.005, 0.01, 0.02, 0.03, 0.05, 0.1, 0.2, 0.3, 0.45};
+    /** Length of the measured impulse responses */
+    const unsigned knImpulseLength = 4 * knBlockSize;
+
+    /** Direction v rotated by (Rz(fYaw) Ry(fPitch) Rx(fRoll))^T */
+    PolarPoint Rotate(PolarPoint position, float fYaw, float fPitch, float fRoll)
+    {
+        float v[3] = {cosf(position.fAzimuth) * cosf(position.fElevation),
+                      sinf(position.fAzimuth) * cosf(position.fElevation),
+                      sinf(position.fElevation)};
+        // Inverse yaw, then pitch, then roll
+        float fX = cosf(fYaw) * v[0] + sinf(fYaw) * v[1];
+        float fY = -sinf(fYaw) * v[0] + cosf(fYaw) * v[1];
+        v[0] = fX;
+        v[1] = fY;
+        fX = cosf(fPitch) * v[0] - sinf(fPitch) * v[2];
+        float fZ = sinf(fPitch) * v[0] + cosf(fPitch) * v[2];
+        v[0] = fX;
+        v[2] = fZ;
+        fY = cosf(fRoll) * v[1] + sinf(fRoll) * v[2];
+        fZ = -sinf(fRoll) * v[1] + cosf(fRoll) * v[2];
+        v[1] = fY;
+        v[2] = fZ;
+        return PolarPoint{atan2f(v[1], v[0]), asinf(std::max(-1.f, std::min(1.f, v[2]))), position.fDistance};
+    }
+
+    /** Encoding of a constant signal at position, nSamples long */
+    void Encode(unsigned nOrder, PolarPoint position, unsigned nSamples, CBFormat& bFormat)
+    {
+        CAmbisonicEncoder encoder;
+        encoder.Configure(nOrder, true, 0);
+        encoder.SetPosition(position);
+        encoder.Refresh();
+        std::vector<float> pfIn(nSamples, 1.f);
+        encoder.Process(pfIn.data(), nSamples, &bFormat);
+    }
+
+    void CheckRotation(unsigned nOrder)
+    {
+        const unsigned nSamples = 16;
+        const float pfOrientations[][3] = {{0.5f, 0.f, 0.f}, {0.f, 0.5f, 0.f}, {0.f, 0.f, 0.5f},
+                                           {0.7f, -0.4f, 0.9f}, {-2.5f, 1.2f, -0.3f}, {3.f, -1.5f, 2.f}};
+        const PolarPoint positions[] = {{0.f, 0.f, 1.f}, {0.3f, 0.2f, 1.f}, {-1.9f, -0.7f, 1.f},
+                                        {2.8f, 1.3f, 1.f}, {1.f, -1.5f, 1.f}};
+
+        CBFormat rotated, expected;
+        rotated.Configure(nOrder, true, nSamples);
+        expected.Configure(nOrder, true, nSamples);
+        std::vector<float> pfRotated(nSamples), pfExpected(nSamples);
+        for(const float* pfOrientation : pfOrientations)
+        {
+            CAmbisonicProcessor processor;
+            processor.Configure(nOrder, true, nSamples, 0);
+            processor.SetShelfFilter(kShelfNone);
+            processor.SetOrientation(Orientation(pfOrientation[0], pfOrientation[1], pfOrientation[2]));
+            processor.Refresh();
+
+            float fError = 0.f;
+            for(const PolarPoint& position : positions)
+            {
+                Encode(nOrder, position, nSamples, rotated);
+                processor.Process(&rotated, nSamples);
+                Encode(nOrder, Rotate(position, pfOrientation[0], pfOrientation[1], pfOrientation[2]), nSamples, expected);
+                for(unsigned niChannel = 0; niChannel < rotated.GetChannelCount(); niChannel++)
+                {
+                    rotated.ExtractStream(pfRotated.data(), niChannel, nSamples);
+                    expected.ExtractStream(pfExpected.data(), niChannel, nSamples);
+                    fError = std::max(fError, test::MaxDifference(pfRotated.data(), pfExpected.data(), nSamples));
+                }
+            }
+            std::string sWhat = "order " + std::to_string(nOrder) + " rotation by (" + std::to_string(pfOrientation[0])
+                + ", " + std::to_string(pfOrientation[1]) + ", " + std::to_string(pfOrientation[2]) + ")";
+            test::Check(fError <= kfRotationTolerance, (sWhat + " is off by " + std::to_string(fError)).c_str());
+        }
+    }
+
+    void CheckProcessor(unsigned nOrder, bool b3D, ProcessorShelfFilters eShelfFilter)
+    {
+        std::string sWhat = "order " + std::to_string(nOrder) + (b3D ? " 3D" : " 2D")
+            + " shelf " + std::to_string((int)eShelfFilter);
+
+        CAmbisonicProcessor processor;
+        if(!test::Check(processor.Configure(nOrder, b3D, knBlockSize, 0), (sWhat + " Configure()").c_str()))
+            return;
+        processor.SetShelfFilter(eShelfFilter);
+        Orientation orientation(0.3f, 0.2f, 0.1f);
+        processor.SetOrientation(orientation);
+        processor.Refresh();
+
+        CBFormat bFormat;
+        bFormat.Configure(nOrder, b3D, knBlockSize);
+        std::vector<float> pfOut(knBlockSize);
+        for(unsigned niBlock = 0; niBlock < knBlocks; niBlock++)
+        {
+            std::vector<float> pfIn;
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+            {
+                pfIn = test::Noise(knBlockSize, 1 + niBlock * 64 + niChannel);
+                bFormat.InsertStream(pfIn.data(), niChannel, knBlockSize);
+            }
+            processor.Process(&bFormat, knBlockSize);
+
+            bool bFinite = true;
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+            {
+                bFormat.ExtractStream(pfOut.data(), niChannel, knBlockSize);
+                for(float fSample : pfOut)
+                    bFinite = bFinite && std::isfinite(fSample);
+            }
+            test::Check(bFinite, (sWhat + " output is not finite").c_str());
+
+            if(nOrder == 0)
+            {
+                pfIn = test::Noise(knBlockSize, 1 + niBlock * 64);
+                bFormat.ExtractStream(pfOut.data(), 0, knBlockSize);
+                test::Check(test::MaxDifference(pfIn.data(), pfOut.data(), knBlockSize) == 0.f,
+                            (sWhat + " changed the W channel").c_str());
+            }
+        }
+    }
+
+    /** Magnitude in dB of the response pfImpulse at dFrequency relative to the sample rate */
+    double MagnitudeDB(const std::vector<float>& pfImpulse, double dFrequency)
+    {
+        double dReal = 0., dImag = 0.;
+        for(unsigned ni = 0; ni < pfImpulse.size(); ni++)
+        {
+            dReal += pfImpulse[ni] * cos(2. * M_PI * dFrequency * ni);
+            dImag -= pfImpulse[ni] * sin(2. * M_PI * dFrequency * ni);
+        }
+        return 10. * log10(dReal * dReal + dImag * dImag);
+    }
+
+    void CompareShelves(const std::vector<float>& pfFIR, const std::vector<float>& pfIIR, const std::string& sWhat)
+    {
+        float fError = 0.f;
+        for(double dFrequency : kpdShelfFrequencies)
+            fError = std::max(fError, (float)std::fabs(MagnitudeDB(pfIIR, dFrequency) - MagnitudeDB(pfFIR, dFrequency)));
+        test::Check(fError <= kfShelfToleranceDB,
+                    (sWhat + " IIR shelf differs from the FIR by " + std::to_string(fError) + " dB").c_str());
+    }
+
+    /** Impulse response of every channel through a 3D processor with eShelfFilter and no rotation */
+    std::vector<std::vector<float>> ProcessorImpulses(unsigned nOrder, ProcessorShelfFilters eShelfFilter)
+    {
+        CAmbisonicProcessor processor;
+        processor.Configure(nOrder, true, knBlockSize, 0);
+        processor.SetShelfFilter(eShelfFilter);
+        processor.SetOrientation(Orientation(0.f, 0.f, 0.f));
+        processor.Refresh();
+
+        CBFormat bFormat;
+        bFormat.Configure(nOrder, true, knBlockSize);
+        std::vector<std::vector<float>> ppfImpulses(bFormat.GetChannelCount());
+        std::vector<float> pfBlock(knBlockSize);
+        for(unsigned niSample = 0; niSample < knImpulseLength; niSample += knBlockSize)
+        {
+            std::fill(pfBlock.begin(), pfBlock.end(), 0.f);
+            pfBlock[0] = niSample == 0 ? 1.f : 0.f;
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+                bFormat.InsertStream(pfBlock.data(), niChannel, knBlockSize);
+            processor.Process(&bFormat, knBlockSize);
+            for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+            {
+                bFormat.ExtractStream(pfBlock.data(), niChannel, knBlockSize);
+                ppfImpulses[niChannel].insert(ppfImpulses[niChannel].end(), pfBlock.begin(), pfBlock.end());
+            }
+        }
+        return ppfImpulses;
+    }
+
+    void CheckShelves3D(unsigned nOrder)
+    {
+        std::vector<std::vector<float>> ppfFIR = ProcessorImpulses(nOrder, kShelfFIR);
+        std::vector<std::vector<float>> ppfIIR = ProcessorImpulses(nOrder, kShelfIIR);
+        for(unsigned niChannel = 0; niChannel < ppfFIR.size(); niChannel++)
+            CompareShelves(ppfFIR[niChannel], ppfIIR[niChannel],
+                           "order " + std::to_string(nOrder) + " 3D channel " + std::to_string(niChannel));
+    }
+
+    /** Responses built from the tables as Configure() does */
+    void CheckShelves2D(unsigned nOrder, const int16_t (*ppnFIR)[101], const PsychoacousticShelf* pShelves)
+    {
+        for(unsigned niOrder = 0; niOrder <= nOrder; niOrder++)
+        {
+            std::vector<float> pfFIR(knImpulseLength, 0.f), pfIIR(knImpulseLength, 0.f);
+            for(unsigned ni = 0; ni < 101; ni++)
+                pfFIR[ni] = 2.f * ppnFIR[niOrder][ni] / 32767.f;
+
+            const PsychoacousticShelf& shelf = pShelves[niOrder];
+            pfIIR[0] = 1.f;
+            CBiquad section;
+            section.SetHighShelf(shelf.fFrequency, 1.f, powf(shelf.fShelfGain, 1.f / shelf.nSections), shelf.fQ);
+            for(unsigned niSection = 0; niSection < shelf.nSections; niSection++)
+            {
+                section.Reset();
+                section.Process(pfIIR.data(), pfIIR.data(), knImpulseLength);
+            }
+            for(float& fSample : pfIIR)
+                fSample *= shelf.fGain;
+
+            CompareShelves(pfFIR, pfIIR, "order " + std::to_string(nOrder) + " 2D order " + std::to_string(niOrder));
+        }
+    }
+}
+
+int main()
+{
+    for(ProcessorShelfFilters eShelfFilter : {kShelfFIR, kShelfIIR, kShelfNone})
+    {
+        CheckProcessor(0, false, eShelfFilter);
+        for(unsigned nOrder = 0; nOrder <= 5; nOrder++)
+            CheckProcessor(nOrder, true, eShelfFilter);
+    }
+    for(unsigned nOrder = 1; nOrder <= 7; nOrder++)
+        CheckRotation(nOrder);
+
+    for(unsigned nOrder = 1; nOrder <= 3; nOrder++)
+        CheckShelves3D(nOrder);
+    CheckShelves2D(1, first_order_2D, first_order_2D_iir);
+    CheckShelves2D(2, second_order_2D, second_order_2D_iir);
+    CheckShelves2D(3, third_order_2D, third_order_2D_iir);
+
+    return test::Result("processor_test");
+}
@@ -0,0 +1,437 @@
+/*
+    Real-time contract: once configured, Process(), Refresh(), Reset() and
+    the parameter setters must not touch the heap. Global operator new, and
+    on glibc malloc() and its relatives, are replaced by counting versions.
+    Each class is configured first, then its real-time calls are made with
+    the counter armed on the calling thread, and any allocation or free fails
+    the test. Allocations of other threads, such as the one building a
+    configuration for ConfigureAsync(), are not counted.
+*/
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "Ambisonics.h"
+#include "AmbisonicBatchEncoder.h"
+#include "BFormatView.h"
+#include "SampleConversion.h"
+#include "SpeakersBinauralizer.h"
+
+#include "TestCommon.h"
+
+namespace {
+    std::atomic<unsigned> nHeapCalls(0);
+    thread_local bool bArmed = false;
+
+    inline void CountHeapCall()
+    {
+        if(bArmed)
+            nHeapCalls++;
+    }
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+    void* __libc_malloc(size_t nSize);
+    void* __libc_calloc(size_t nCount, size_t nSize);
+    void* __libc_realloc(void* p, size_t nSize);
+    void* __libc_memalign(size_t nAlignment, size_t nSize);
+    void __libc_free(void* p);
+
+    void* malloc(size_t nSize)
+    {
+        CountHeapCall();
+        return __libc_malloc(nSize);
+    }
+    void* calloc(size_t nCount, size_t nSize)
+    {
+        CountHeapCall();
+        return __libc_calloc(nCount, nSize);
+    }
+    void* realloc(void* p, size_t nSize)
+    {
+        CountHeapCall();
+        return __libc_realloc(p, nSize);
+    }
+    void* aligned_alloc(size_t nAlignment, size_t nSize)
+    {
+        CountHeapCall();
+        return __libc_memalign(nAlignment, nSize);
+    }
+    void* memalign(size_t nAlignment, size_t nSize)
+    {
+        CountHeapCall();
+        return __libc_memalign(nAlignment, nSize);
+    }
+    int posix_memalign(void** pp, size_t nAlignment, size_t nSize)
+    {
+        CountHeapCall();
+        *pp = __libc_memalign(nAlignment, nSize);
+        return *pp ? 0 : ENOMEM;
+    }
+    void free(void* p)
+    {
+        if(p)
+            CountHeapCall();
+        __libc_free(p);
+    }
+}
+#endif
+
+void* operator new(size_t nSize)
+{
+#if !defined(__GLIBC__)
+    CountHeapCall();
+#endif
+    void* p = std::malloc(nSize ? nSize : 1);
+    if(!p)
+        throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t nSize)
+{
+    return operator new(nSize);
+}
+void* operator new(size_t nSize, const std::nothrow_t&) noexcept
+{
+#if !defined(__GLIBC__)
+    CountHeapCall();
+#endif
+    return std::malloc(nSize ? nSize : 1);
+}
+void* operator new[](size_t nSize, const std::nothrow_t& tag) noexcept
+{
+    return operator new(nSize, tag);
+}
+void operator delete(void* p) noexcept
+{
+#if !defined(__GLIBC__)
+    if(p)
+        CountHeapCall();
+#endif
+    std::free(p);
+}
+void operator delete[](void* p) noexcept
+{
+    operator delete(p);
+}
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+void operator delete[](void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+namespace {
+    const unsigned knSampleRate = 48000;
+    const unsigned knBlockSize = 512;
+    const unsigned knOrder = 3;
+
+    /** Runs f with the counter armed and fails if it used the heap */
+    template<typename F>
+    void CheckNoHeap(const char* pcWhat, F f)
+    {
+        nHeapCalls = 0;
+        bArmed = true;
+        f();
+        bArmed = false;
+        unsigned nCalls = nHeapCalls;
+        if(nCalls)
+            fprintf(stderr, "%s: %u heap call(s)\n", pcWhat, nCalls);
+        test::Check(nCalls == 0, pcWhat);
+    }
+
+    /** Planar buffers, nChannels of nSamples */
+    struct Buffers {
+        Buffers(unsigned nChannels, unsigned nSamples)
+            : pfData(test::Noise(nChannels * nSamples))
+            , ppf(nChannels)
+        {
+            for(unsigned niChannel = 0; niChannel < nChannels; niChannel++)
+                ppf[niChannel] = &pfData[niChannel * nSamples];
+        }
+        std::vector<float> pfData;
+        std::vector<float*> ppf;
+    };
+
+    void FillBFormat(CBFormat& bFormat)
+    {
+        std::vector<float> pfNoise = test::Noise(knBlockSize);
+        for(unsigned niChannel = 0; niChannel < bFormat.GetChannelCount(); niChannel++)
+            bFormat.InsertStream(pfNoise.data(), niChannel, knBlockSize);
+    }
+
+    const PolarPoint kPosition = {0.5f, 0.2f, 2.f};
+    const PolarPoint kOtherPosition = {-1.f, -0.1f, 0.5f};
+
+    void CheckEncoders()
+    {
+        std::vector<float> pfIn = test::Noise(knBlockSize);
+        CBFormat bFormat;
+        bFormat.Configure(knOrder, true, knBlockSize);
+
+        CAmbisonicEncoder encoder;
+        encoder.Configure(knOrder, true, 0);
+        CheckNoHeap("CAmbisonicEncoder", [&] {
+            encoder.SetPosition(kPosition);
+            encoder.SetGain(0.5f);
+            encoder.SetOrderWeight(1, 0.8f);
+            encoder.Refresh();
+            encoder.Process(pfIn.data(), knBlockSize, &bFormat);
+            encoder.SetInterpolation(true);
+            encoder.Process(pfIn.data(), knBlockSize, &bFormat);
+            encoder.PostPosition(kOtherPosition);
+            encoder.Process(pfIn.data(), knBlockSize, &bFormat);
+            encoder.Reset();
+        });
+
+        CAmbisonicEncoderDist encoderDist;
+        encoderDist.Configure(knOrder, true, knSampleRate);
+        CheckNoHeap("CAmbisonicEncoderDist", [&] {
+            encoderDist.SetPosition(kPosition);
+            encoderDist.SetRoomRadius(3.f);
+            encoderDist.Refresh();
+            encoderDist.Process(pfIn.data(), knBlockSize, &bFormat);
+            encoderDist.SetInterpolation(true);
+            encoderDist.Process(pfIn.data(), knBlockSize, &bFormat);
+            encoderDist.PostPosition(kOtherPosition);
+            encoderDist.Process(pfIn.data(), knBlockSize, &bFormat);
+            encoderDist.Reset();
+        });
+
+        const unsigned nSources = 8;
+        Buffers sources(nSources, knBlockSize);
+        CAmbisonicBatchEncoder batchEncoder;
+        batchEncoder.Configure(knOrder, true, nSources);
+        CheckNoHeap("CAmbisonicBatchEncoder", [&] {
+            for(unsigned niSource = 0; niSource < nSources; niSource++)
+            {
+                batchEncoder.SetPosition(niSource, kPosition);
+                batchEncoder.SetGain(niSource, 0.5f);
+            }
+            batchEncoder.Refresh();
+            batchEncoder.Process(sources.ppf.data(), knBlockSize, &bFormat);
+            batchEncoder.Reset();
+        });
+    }
+
+    void CheckDecoders()
+    {
+        CBFormat bFormat;
+        bFormat.Configure(knOrder, true, knBlockSize);
+        FillBFormat(bFormat);
+
+        CAmbisonicDecoder decoder;
+        decoder.Configure(knOrder, true, kAmblib_Dodecahedron);
+        Buffers speakers(decoder.GetSpeakerCount(), knBlockSize);
+        CheckNoHeap("CAmbisonicDecoder", [&] {
+            decoder.SetPosition(0, kPosition);
+            decoder.SetOrderWeight(1, 1, 0.9f);
+            decoder.Refresh();
+            decoder.Process(&bFormat, knBlockSize, speakers.ppf.data());
+            decoder.SetCoefficient(2, 1, 0.1f);
+            decoder.Process(&bFormat, knBlockSize, speakers.ppf.data());
+            decoder.SetDualBand(true, knSampleRate);
+            decoder.Process(&bFormat, knBlockSize, speakers.ppf.data());
+            decoder.SetDualBand(true, knSampleRate, 500.f);
+            decoder.Process(&bFormat, 100, speakers.ppf.data());
+            decoder.SetDualBand(false);
+            decoder.Process(&bFormat, knBlockSize, speakers.ppf.data());
+            decoder.Reset();
+        });
+
+        std::vector<float> pfOut(knBlockSize);
+        CAmbisonicSpeaker speaker;
+        speaker.Configure(knOrder, true, 0);
+        CheckNoHeap("CAmbisonicSpeaker", [&] {
+            speaker.SetPosition(kPosition);
+            speaker.Refresh();
+            speaker.Process(&bFormat, knBlockSize, pfOut.data());
+            speaker.PostPosition(kOtherPosition);
+            speaker.Process(&bFormat, knBlockSize, pfOut.data());
+        });
+
+        CAmbisonicMicrophone microphone;
+        microphone.Configure(knOrder, true, 0);
+        CheckNoHeap("CAmbisonicMicrophone", [&] {
+            microphone.SetPosition(kPosition);
+            microphone.SetDirectivity(0.5f);
+            microphone.Refresh();
+            microphone.Process(&bFormat, knBlockSize, pfOut.data());
+            microphone.PostDirectivity(0.2f);
+            microphone.PostPosition(kOtherPosition);
+            microphone.Process(&bFormat, knBlockSize, pfOut.data());
+        });
+    }
+
+    void CheckProcessors()
+    {
+        CBFormat bFormat;
+        bFormat.Configure(knOrder, true, knBlockSize);
+        FillBFormat(bFormat);
+
+        CAmbisonicProcessor processor;
+        processor.Configure(knOrder, true, knBlockSize, 0);
+        CheckNoHeap("CAmbisonicProcessor", [&] {
+            processor.SetRampLength(256);
+            processor.SetOrientation(Orientation(0.3f, 0.2f, 0.1f));
+            processor.Refresh();
+            processor.Process(&bFormat, knBlockSize);
+            processor.SetShelfFilter(kShelfIIR);
+            processor.Process(&bFormat, knBlockSize);
+            processor.SetShelfFilter(kShelfNone);
+            processor.PostOrientation(Orientation(-0.3f, 0.f, 0.f));
+            processor.Process(&bFormat, knBlockSize);
+            processor.SetShelfFilter(kShelfFIR);
+            processor.Process(&bFormat, knBlockSize);
+            processor.Reset();
+        });
+
+        CBFormat bFormatFirst;
+        bFormatFirst.Configure(1, true, knBlockSize);
+        FillBFormat(bFormatFirst);
+        CAmbisonicZoomer zoomer;
+        zoomer.Configure(1, true, 0);
+        CheckNoHeap("CAmbisonicZoomer", [&] {
+            zoomer.SetZoom(0.5f);
+            zoomer.Refresh();
+            zoomer.Process(&bFormatFirst, knBlockSize);
+            zoomer.PostZoom(-0.5f);
+            zoomer.Process(&bFormatFirst, knBlockSize);
+            zoomer.Reset();
+        });
+    }
+
+    void CheckBinauralizers()
+    {
+        CBFormat bFormat;
+        bFormat.Configure(knOrder, true, knBlockSize);
+        FillBFormat(bFormat);
+        Buffers ears(2, knBlockSize);
+        unsigned nTail = 0;
+
+        CAmbisonicBinauralizer binauralizer;
+        if(!test::Check(binauralizer.Configure(knOrder, true, knSampleRate, knBlockSize, nTail),
+                        "CAmbisonicBinauralizer Configure()"))
+            return;
+        CheckNoHeap("CAmbisonicBinauralizer", [&] {
+            binauralizer.Process(&bFormat, ears.ppf.data());
+            binauralizer.SetLowCPU(true);
+            binauralizer.Process(&bFormat, ears.ppf.data());
+            binauralizer.SetLowCPU(false);
+            binauralizer.Refresh();
+            binauralizer.Reset();
+        });
+
+        // Switch to a configuration built in the background, with a crossfade
+        binauralizer.ConfigureAsync(knOrder, true, knSampleRate, knBlockSize, "", true);
+        binauralizer.WaitForConfigure(nTail);
+        CheckNoHeap("CAmbisonicBinauralizer switch to ConfigureAsync()", [&] {
+            binauralizer.Process(&bFormat, ears.ppf.data());
+            binauralizer.Process(&bFormat, ears.ppf.data());
+        });
+        test::Check(!binauralizer.IsConfigurePending(), "ConfigureAsync() was not switched to");
+
+        CAmbisonicBinauralizer fifoBinauralizer;
+        fifoBinauralizer.Configure(knOrder, true, knSampleRate, knBlockSize, nTail);
+        CheckNoHeap("CAmbisonicBinauralizer any block size", [&] {
+            for(unsigned nSamples : {1u, 100u, 300u, knBlockSize})
+                fifoBinauralizer.Process(&bFormat, ears.ppf.data(), nSamples);
+            fifoBinauralizer.Reset();
+        });
+
+        const unsigned nSpeakers = 5;
+        const float pfAzimuths[nSpeakers] = {0.f, 0.5f, -0.5f, 1.9f, -1.9f};
+        CAmbisonicSpeaker speakers[nSpeakers];
+        for(unsigned niSpeaker = 0; niSpeaker < nSpeakers; niSpeaker++)
+        {
+            speakers[niSpeaker].Configure(1, true, 0);
+            speakers[niSpeaker].SetPosition(PolarPoint{pfAzimuths[niSpeaker], 0.f, 1.f});
+            speakers[niSpeaker].Refresh();
+        }
+        Buffers feeds(nSpeakers, knBlockSize);
+        SpeakersBinauralizer speakersBinauralizer;
+        if(!test::Check(speakersBinauralizer.Configure(knSampleRate, knBlockSize, speakers, nSpeakers, nTail),
+                        "SpeakersBinauralizer Configure()"))
+            return;
+        CheckNoHeap("SpeakersBinauralizer", [&] {
+            speakersBinauralizer.Process(feeds.ppf.data(), ears.ppf.data());
+            speakersBinauralizer.Reset();
+        });
+        SpeakersBinauralizer fifoSpeakersBinauralizer;
+        fifoSpeakersBinauralizer.Configure(knSampleRate, knBlockSize, speakers, nSpeakers, nTail);
+        CheckNoHeap("SpeakersBinauralizer any block size", [&] {
+            for(unsigned nSamples : {1u, 100u, 300u, knBlockSize})
+                fifoSpeakersBinauralizer.Process(feeds.ppf.data(), ears.ppf.data(), nSamples);
+        });
+    }
+
+    void CheckBuffers()
+    {
+        CBFormat bFormat, bFormatOther;
+        bFormat.Configure(knOrder, true, knBlockSize);
+        bFormatOther.Configure(knOrder, true, knBlockSize);
+        unsigned nChannels = bFormat.GetChannelCount();
+        std::vector<float> pfStream = test::Noise(knBlockSize);
+        std::vector<float> pfInterleaved(nChannels * knBlockSize);
+        std::vector<int16_t> psInterleaved(nChannels * knBlockSize);
+        std::vector<int32_t> pnInterleaved(nChannels * knBlockSize);
+        CDither dither(16);
+        Buffers planar(nChannels, knBlockSize);
+
+        CheckNoHeap("CBFormat", [&] {
+            bFormat.Reset();
+            bFormat.InsertStream(pfStream.data(), 0, knBlockSize);
+            bFormat.ExtractStream(pfStream.data(), 0, knBlockSize);
+            bFormatOther = bFormat;
+            bFormat += bFormatOther;
+            bFormat *= 0.5f;
+            bFormat.InsertInterleaved(pfInterleaved.data(), nChannels, knBlockSize);
+            bFormat.ExtractInterleaved(psInterleaved.data(), nChannels, knBlockSize, &dither);
+            bFormat.InsertInterleaved(psInterleaved.data(), nChannels, knBlockSize);
+            bFormat.ExtractInterleaved(pnInterleaved.data(), nChannels, knBlockSize);
+            bFormat.InsertInterleaved(pnInterleaved.data(), nChannels, knBlockSize);
+            bFormat.ExtractInterleaved(pfInterleaved.data(), nChannels, knBlockSize);
+        });
+
+        CBFormatView view;
+        view.Configure(knOrder, true, knBlockSize);
+        CheckNoHeap("CBFormatView", [&] {
+            view.SetChannels(planar.ppf.data());
+            view.Reset();
+            view.SetChannels(planar.pfData.data(), knBlockSize);
+            view = bFormat;
+        });
+
+        CheckNoHeap("Interleave() and Deinterleave()", [&] {
+            Interleave(planar.ppf.data(), nChannels, knBlockSize, psInterleaved.data(), nChannels, &dither);
+            Deinterleave(psInterleaved.data(), nChannels, planar.ppf.data(), nChannels, knBlockSize);
+            Interleave(planar.ppf.data(), nChannels, knBlockSize, pfInterleaved.data(), nChannels);
+            Deinterleave(pfInterleaved.data(), nChannels, planar.ppf.data(), nChannels, knBlockSize);
+        });
+    }
+}
+
+int main()
+{
+    // The hooks must see the allocations of the library, or the test proves nothing
+    CheckNoHeap("nothing", [] { });
+    nHeapCalls = 0;
+    bArmed = true;
+    delete new std::vector<float>(16);
+    bArmed = false;
+    if(!test::Check(nHeapCalls > 0, "the allocation hooks are not called"))
+        return test::Result("realtime_test");
+
+    CheckEncoders();
+    CheckDecoders();
+    CheckProcessors();
+    CheckBinauralizers();
+    CheckBuffers();
+
+    return test::Result("realtime_test");
+}
@@ -0,0 +1,214 @@
+/*
+    Interleaving and sample format conversion. The SSE2 code converts blocks
+    of four frames by four channels and the scalar code the rest, so a call
+    covering whole blocks must give the same samples as calls of one channel
+    and one frame, which only use the scalar code. Conversion to int16_t,
+    24-bit samples in int32_t and int32_t must round and saturate at full
+    scale and beyond, and back to float must map full scale to -1. The TPDF
+    dither must stay within one least significant bit of the output, give
+    the same noise from both code paths, and the same sequence for a seed.
+*/
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SampleConversion.h"
+
+#include "TestCommon.h"
+
+namespace {
+    const unsigned knChannels = 8;
+    const unsigned knSamples = 64;
+
+    /** Planar test signal spanning twice full scale, with exact full scale values */
+    std::vector<std::vector<float>> Signal()
+    {
+        std::vector<std::vector<float>> ppfSignal;
+        for(unsigned niChannel = 0; niChannel < knChannels; niChannel++)
+        {
+            std::vector<float> pfChannel = test::Noise(knSamples, 11 + niChannel);
+            for(float& fSample : pfChannel)
+                fSample *= 4.f;
+            pfChannel[0] = 1.f;
+            pfChannel[1] = -1.f;
+            pfChannel[2] = 0.5f / 32768.f;
+            pfChannel[3] = -1.5f / 32768.f;
+            ppfSignal.push_back(pfChannel);
+        }
+        return ppfSignal;
+    }
+
+    std::vector<const float*> Pointers(const std::vector<std::vector<float>>& ppf)
+    {
+        std::vector<const float*> ppfPointers;
+        for(const std::vector<float>& pf : ppf)
+            ppfPointers.push_back(pf.data());
+        return ppfPointers;
+    }
+
+    /** Interleave in one call, and one sample of one channel per call */
+    template<typename T>
+    void CheckInterleavePaths(const std::string& sType)
+    {
+        std::vector<std::vector<float>> ppfSignal = Signal();
+        std::vector<const float*> ppfSrc = Pointers(ppfSignal);
+        const unsigned nFrameStride = knChannels + 1;
+        std::vector<T> pWhole(knSamples * nFrameStride, 0), pSingle(knSamples * nFrameStride, 0);
+
+        Interleave(ppfSrc.data(), knChannels, knSamples, pWhole.data(), nFrameStride);
+        for(unsigned niSample = 0; niSample < knSamples; niSample++)
+            for(unsigned niChannel = 0; niChannel < knChannels; niChannel++)
+            {
+                const float* pfSample = &ppfSignal[niChannel][niSample];
+                Interleave(&pfSample, 1, 1, &pSingle[niSample * nFrameStride + niChannel], nFrameStride);
+            }
+        test::Check(pWhole == pSingle, ("Interleave() to " + sType + " differs between the code paths").c_str());
+
+        bool bPadding = true;
+        for(unsigned niSample = 0; niSample < knSamples; niSample++)
+            bPadding = bPadding && pWhole[niSample * nFrameStride + knChannels] == 0;
+        test::Check(bPadding, ("Interleave() to " + sType + " wrote beyond the channels").c_str());
+
+        std::vector<std::vector<float>> ppfWhole(knChannels, std::vector<float>(knSamples));
+        std::vector<std::vector<float>> ppfSingle = ppfWhole;
+        std::vector<float*> ppfDst;
+        for(std::vector<float>& pf : ppfWhole)
+            ppfDst.push_back(pf.data());
+        Deinterleave(pWhole.data(), nFrameStride, ppfDst.data(), knChannels, knSamples);
+        for(unsigned niSample = 0; niSample < knSamples; niSample++)
+            for(unsigned niChannel = 0; niChannel < knChannels; niChannel++)
+            {
+                float* pfSample = &ppfSingle[niChannel][niSample];
+                Deinterleave(&pWhole[niSample * nFrameStride + niChannel], nFrameStride, &pfSample, 1, 1);
+            }
+        test::Check(ppfWhole == ppfSingle, ("Deinterleave() from " + sType + " differs between the code paths").c_str());
+    }
+
+    /** Convert four frames of four channels, so the SSE2 code is used where
+        available. Sample i of every channel is pfValues[i]. */
+    template<typename T>
+    std::vector<T> Convert(const float pfValues[4])
+    {
+        std::vector<std::vector<float>> ppfSignal(4, std::vector<float>(pfValues, pfValues + 4));
+        std::vector<const float*> ppfSrc = Pointers(ppfSignal);
+        std::vector<T> pDst(16);
+        Interleave(ppfSrc.data(), 4, 4, pDst.data(), 4);
+        return pDst;
+    }
+
+    template<typename T>
+    void CheckConversion(const float pfValues[4], const T pExpected[4], const std::string& sWhat)
+    {
+        std::vector<T> pConverted = Convert<T>(pfValues);
+        bool bCorrect = true;
+        for(unsigned ni = 0; ni < 16; ni++)
+            bCorrect = bCorrect && pConverted[ni] == pExpected[ni / 4];
+        test::Check(bCorrect, sWhat.c_str());
+    }
+
+    void CheckSaturation()
+    {
+        // Full scale, beyond, and rounding to the nearest value
+        const float pfFullScale[4] = {1.f, -1.f, 2.f, -3.f};
+        const float pfRounding[4] = {0.75f / 32768.f, -0.75f / 32768.f, 32766.6f / 32768.f, -32767.4f / 32768.f};
+
+        const int16_t psFullScale[4] = {32767, -32768, 32767, -32768};
+        const int16_t psRounding[4] = {1, -1, 32767, -32767};
+        CheckConversion(pfFullScale, psFullScale, "int16_t does not saturate");
+        CheckConversion(pfRounding, psRounding, "int16_t does not round to the nearest value");
+
+        // 24-bit samples are left-aligned in the 32-bit words
+        std::vector<int32_t> pnFullScale = Convert<int32_t>(pfFullScale);
+        bool bSaturated24 = true;
+        for(unsigned ni = 0; ni < 16; ni++)
+            bSaturated24 = bSaturated24 && (pnFullScale[ni] >> 8) == ((ni / 4) % 2 == 0 ? 8388607 : -8388608);
+        test::Check(bSaturated24, "24-bit samples do not saturate");
+        // Values on the 24-bit grid convert exactly, as 24 bits fit in a float
+        const float pf24Bit[4] = {1.f / 8388608.f, -1.f / 8388608.f, 8388606.f / 8388608.f, -8388607.f / 8388608.f};
+        const int32_t pn24Bit[4] = {256, -256, 8388606 * 256, -8388607 * 256};
+        CheckConversion(pf24Bit, pn24Bit, "24-bit samples are not exact");
+
+        // The largest float below 2^31 is the largest int32_t reachable
+        const int32_t pnFullScaleExpected[4] = {2147483520, INT32_MIN, 2147483520, INT32_MIN};
+        CheckConversion(pfFullScale, pnFullScaleExpected, "int32_t does not saturate");
+
+        // And back to float
+        const int16_t psExtremes[4] = {INT16_MIN, INT16_MAX, 0, -1};
+        const int32_t pnExtremes[4] = {INT32_MIN, INT32_MAX, 0, -256};
+        float pfFrom16[4], pfFrom32[4];
+        float* ppfFrom16[4] = {&pfFrom16[0], &pfFrom16[1], &pfFrom16[2], &pfFrom16[3]};
+        float* ppfFrom32[4] = {&pfFrom32[0], &pfFrom32[1], &pfFrom32[2], &pfFrom32[3]};
+        Deinterleave(psExtremes, 4, ppfFrom16, 4, 1);
+        Deinterleave(pnExtremes, 4, ppfFrom32, 4, 1);
+        test::Check(pfFrom16[0] == -1.f && pfFrom16[1] == 32767.f / 32768.f && pfFrom16[2] == 0.f
+                    && pfFrom16[3] == -1.f / 32768.f, "int16_t to float is wrong");
+        test::Check(pfFrom32[0] == -1.f && pfFrom32[1] == 1.f && pfFrom32[2] == 0.f
+                    && pfFrom32[3] == -1.f / 8388608.f, "int32_t to float is wrong");
+    }
+
+    void CheckDither()
+    {
+        const unsigned nNoise = 4096;
+        for(unsigned nBits : {16u, 24u})
+        {
+            std::string sBits = std::to_string(nBits) + "-bit dither";
+            float fLSB = 1.f / (float)(1u << (nBits - 1));
+
+            CDither dither(nBits, 7), sameSeed(nBits, 7), otherSeed(nBits, 8);
+            std::vector<float> pfNoise(nNoise), pfSameSeed(nNoise), pfOtherSeed(nNoise);
+            dither.Generate(pfNoise.data(), nNoise);
+            sameSeed.Generate(pfSameSeed.data(), nNoise);
+            otherSeed.Generate(pfOtherSeed.data(), nNoise);
+            test::Check(pfNoise == pfSameSeed, (sBits + " differs for the same seed").c_str());
+            test::Check(pfNoise != pfOtherSeed, (sBits + " is the same for another seed").c_str());
+
+            float fMax = test::MaxAbs(pfNoise.data(), nNoise);
+            double dMean = 0.;
+            for(float fSample : pfNoise)
+                dMean += fSample;
+            dMean /= nNoise;
+            test::Check(fMax <= fLSB, (sBits + " exceeds one LSB").c_str());
+            test::Check(fMax > 0.9f * fLSB, (sBits + " does not span one LSB").c_str());
+            test::Check(std::fabs(dMean) < 0.05 * fLSB, (sBits + " is not centred").c_str());
+
+            // The scalar code runs for calls of fewer than 16 samples, each drawing all 16 generators
+            CDither scalar(nBits, 7);
+            bool bSame = true;
+            for(unsigned niDraw = 0; niDraw < nNoise / 16; niDraw++)
+            {
+                float afNoise[15];
+                scalar.Generate(afNoise, 15);
+                for(unsigned ni = 0; ni < 15; ni++)
+                    bSame = bSame && afNoise[ni] == pfNoise[16 * niDraw + ni];
+            }
+            test::Check(bSame, (sBits + " differs between the code paths").c_str());
+        }
+
+        // Silence dithered to int16_t stays within one LSB
+        std::vector<std::vector<float>> ppfSilence(knChannels, std::vector<float>(knSamples, 0.f));
+        std::vector<const float*> ppfSrc = Pointers(ppfSilence);
+        std::vector<int16_t> psDst(knChannels * knSamples);
+        CDither dither(16, 3);
+        Interleave(ppfSrc.data(), knChannels, knSamples, psDst.data(), knChannels, &dither);
+        bool bWithinLSB = true, bNonZero = false;
+        for(int16_t sSample : psDst)
+        {
+            bWithinLSB = bWithinLSB && sSample >= -1 && sSample <= 1;
+            bNonZero = bNonZero || sSample != 0;
+        }
+        test::Check(bWithinLSB && bNonZero, "dithered silence is not within one LSB");
+    }
+}
+
+int main()
+{
+    CheckInterleavePaths<float>("float");
+    CheckInterleavePaths<int16_t>("int16_t");
+    CheckInterleavePaths<int32_t>("int32_t");
+    CheckSaturation();
+    CheckDither();
+
+    return test::Result("sample_conversion_test");
+}
@@ -0,0 +1,123 @@
+/*
+    Complex products of spectra. Every version of spectrumMultiply() and
+    spectrumMultiplyAccumulate() compiled in and supported by the CPU (see
+    spectrumKernels()) is compared with the products computed in double
+    precision. The lengths cover every remainder of the vector widths, so
+    the scalar code finishing the SIMD loops is checked too, and the buffers
+    start one bin off their alignment. Bins past the end must be left
+    untouched, and the product may be written over either operand.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "spectrum.h"
+
+#include "TestCommon.h"
+
+namespace {
+    /** Largest error allowed, relative to the magnitude of the terms summed.
+        FMA rounds differently, so this is a few float epsilons. */
+    const double kdTolerance = 4e-7;
+    /** Every remainder of four bins, short and long */
+    const unsigned knLengths[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 31, 33, 257, 1023, 1025};
+    /** Value of the bins past the end */
+    const float kfGuard = 12345.f;
+
+    std::vector<kiss_fft_cpx> Spectrum(unsigned nBins, unsigned nSeed)
+    {
+        std::vector<float> pfNoise = test::Noise(2 * nBins, nSeed);
+        std::vector<kiss_fft_cpx> pcp(nBins);
+        for(unsigned ni = 0; ni < nBins; ni++)
+            pcp[ni] = {pfNoise[2 * ni], pfNoise[2 * ni + 1]};
+        return pcp;
+    }
+
+    /** Copy of pcp between two guard bins */
+    std::vector<kiss_fft_cpx> Guarded(const std::vector<kiss_fft_cpx>& pcp)
+    {
+        std::vector<kiss_fft_cpx> pcpGuarded(pcp.size() + 2, kiss_fft_cpx{kfGuard, kfGuard});
+        std::copy(pcp.begin(), pcp.end(), pcpGuarded.begin() + 1);
+        return pcpGuarded;
+    }
+
+    bool Guards(const std::vector<kiss_fft_cpx>& pcpGuarded)
+    {
+        const kiss_fft_cpx& cpFirst = pcpGuarded.front();
+        const kiss_fft_cpx& cpLast = pcpGuarded.back();
+        return cpFirst.r == kfGuard && cpFirst.i == kfGuard && cpLast.r == kfGuard && cpLast.i == kfGuard;
+    }
+
+    /** pcpDst (guarded) against pcpAcc + pcpA * pcpB in double precision */
+    bool Matches(const std::vector<kiss_fft_cpx>& pcpA, const std::vector<kiss_fft_cpx>& pcpB,
+                 const std::vector<kiss_fft_cpx>& pcpAcc, const std::vector<kiss_fft_cpx>& pcpDst)
+    {
+        for(unsigned ni = 0; ni < pcpA.size(); ni++)
+        {
+            double dAr = pcpA[ni].r, dAi = pcpA[ni].i, dBr = pcpB[ni].r, dBi = pcpB[ni].i;
+            double dRe = pcpAcc[ni].r + dAr * dBr - dAi * dBi;
+            double dIm = pcpAcc[ni].i + dAr * dBi + dAi * dBr;
+            double dScale = std::fabs(pcpAcc[ni].r) + std::fabs(pcpAcc[ni].i)
+                            + (std::fabs(dAr) + std::fabs(dAi)) * (std::fabs(dBr) + std::fabs(dBi));
+            if(std::fabs(pcpDst[ni + 1].r - dRe) > kdTolerance * dScale
+               || std::fabs(pcpDst[ni + 1].i - dIm) > kdTolerance * dScale)
+                return false;
+        }
+        return Guards(pcpDst);
+    }
+
+    void CheckKernel(const SpectrumKernel& kernel)
+    {
+        for(unsigned nBins : knLengths)
+        {
+            std::string sWhat = std::string(kernel.name) + " with " + std::to_string(nBins) + " bins";
+            std::vector<kiss_fft_cpx> pcpA = Spectrum(nBins, 1), pcpB = Spectrum(nBins, 2), pcpAcc = Spectrum(nBins, 3);
+            std::vector<kiss_fft_cpx> pcpZero(nBins, kiss_fft_cpx{0.f, 0.f});
+            std::vector<kiss_fft_cpx> pcpGuardedA = Guarded(pcpA), pcpGuardedB = Guarded(pcpB);
+
+            std::vector<kiss_fft_cpx> pcpDst = Guarded(pcpZero);
+            kernel.multiply(&pcpGuardedA[1], &pcpGuardedB[1], &pcpDst[1], nBins);
+            test::Check(Matches(pcpA, pcpB, pcpZero, pcpDst), (sWhat + ": multiply is wrong").c_str());
+
+            pcpDst = Guarded(pcpAcc);
+            kernel.multiplyAccumulate(&pcpGuardedA[1], &pcpGuardedB[1], &pcpDst[1], nBins);
+            test::Check(Matches(pcpA, pcpB, pcpAcc, pcpDst), (sWhat + ": multiply-accumulate is wrong").c_str());
+
+            // In place, over either operand
+            pcpDst = Guarded(pcpA);
+            kernel.multiply(&pcpDst[1], &pcpGuardedB[1], &pcpDst[1], nBins);
+            test::Check(Matches(pcpA, pcpB, pcpZero, pcpDst), (sWhat + ": multiply over A is wrong").c_str());
+            pcpDst = Guarded(pcpB);
+            kernel.multiply(&pcpGuardedA[1], &pcpDst[1], &pcpDst[1], nBins);
+            test::Check(Matches(pcpA, pcpB, pcpZero, pcpDst), (sWhat + ": multiply over B is wrong").c_str());
+        }
+    }
+}
+
+int main()
+{
+    std::vector<SpectrumKernel> kernels = spectrumKernels();
+    for(const SpectrumKernel& kernel : kernels)
+    {
+        printf("Checking the %s kernels\n", kernel.name);
+        CheckKernel(kernel);
+    }
+    test::Check(!kernels.empty() && std::string(kernels.back().name) == spectrumKernelName(),
+                "the fastest kernel is not the one in use");
+
+    // The functions in use, on a length with a remainder
+    const unsigned nBins = 1025;
+    std::vector<kiss_fft_cpx> pcpA = Spectrum(nBins, 4), pcpB = Spectrum(nBins, 5), pcpAcc = Spectrum(nBins, 6);
+    std::vector<kiss_fft_cpx> pcpDst = Guarded(pcpAcc);
+    spectrumMultiplyAccumulate(pcpA.data(), pcpB.data(), &pcpDst[1], nBins);
+    test::Check(Matches(pcpA, pcpB, pcpAcc, pcpDst), "spectrumMultiplyAccumulate() is wrong");
+    std::vector<kiss_fft_cpx> pcpZero(nBins, kiss_fft_cpx{0.f, 0.f});
+    pcpDst = Guarded(pcpZero);
+    spectrumMultiply(pcpA.data(), pcpB.data(), &pcpDst[1], nBins);
+    test::Check(Matches(pcpA, pcpB, pcpZero, pcpDst), "spectrumMultiply() is wrong");
+
+    return test::Result("spectrum_test");
+}